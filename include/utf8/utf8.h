@@ -128,4 +128,681 @@ const char * utf8_validate( const char * _utf8, const char * _utf8End );
  */
 const char * utf8_replace_invalid( const char * _utf8, const char * _utf8End, char * const _utf8Out );
 
+/**
+ * Returns the end of the extended grapheme cluster (UAX #29) that starts at _utf8.
+ *
+ * @param _utf8    Start of a grapheme cluster (a cluster boundary).
+ * @param _utf8End End of sequence (one-past-last byte).
+ *
+ * @return Pointer to the byte after the grapheme cluster, or NULL on error
+ *         (invalid UTF-8 at _utf8, empty range, or NULL arguments). Invalid
+ *         UTF-8 following the first code point terminates the cluster.
+ */
+const char * utf8_next_grapheme( const char * _utf8, const char * _utf8End );
+
+/**
+ * Counts extended grapheme clusters (UAX #29) in [_utf8, _utf8End).
+ *
+ * @param _utf8    Start of UTF-8 sequence.
+ * @param _utf8End End of sequence (one-past-last byte).
+ *
+ * @return Number of grapheme clusters, or UTF8_UNKNOWN on invalid UTF-8.
+ */
+size_t utf8_grapheme_count( const char * _utf8, const char * _utf8End );
+
+/**
+ * Returns the number of terminal columns needed to display [_utf8, _utf8End).
+ *
+ * Locale-independent: East Asian Wide/Fullwidth characters take 2 columns,
+ * combining marks, format and control characters take 0, everything else 1.
+ *
+ * @param _utf8    Start of UTF-8 sequence.
+ * @param _utf8End End of sequence (one-past-last byte).
+ *
+ * @return Display width in columns, or UTF8_UNKNOWN on invalid UTF-8.
+ */
+size_t utf8_display_width( const char * _utf8, const char * _utf8End );
+
+/**
+ * Finds the longest prefix of [_utf8, _utf8End) that fits in _columns columns.
+ *
+ * Zero-width code points that follow the last kept character are kept with
+ * it; a wide character that does not fit is dropped entirely.
+ *
+ * @param _utf8    Start of UTF-8 sequence.
+ * @param _utf8End End of sequence (one-past-last byte).
+ * @param _columns Maximum display width.
+ * @param _width   Optional: where to store the display width of the prefix.
+ *
+ * @return Pointer to the end of the prefix, or NULL on invalid UTF-8 before the
+ *         column limit is reached.
+ */
+const char * utf8_display_truncate( const char * _utf8, const char * _utf8End, size_t _columns, size_t * const _width );
+
+/**
+ * Finds the first occurrence of a UTF-8 needle in [_utf8, _utf8End).
+ *
+ * Hits always start and end on code point boundaries: the needle must be
+ * valid UTF-8 and a hit followed by a continuation byte is rejected.
+ *
+ * Candidates come from a first/last-byte filter; when a repetitive haystack
+ * makes the filter pass too often the scan switches to two-way matching,
+ * which keeps the search linear in the haystack size.
+ *
+ * @param _utf8      Start of UTF-8 haystack.
+ * @param _utf8End   End of haystack (one-past-last byte).
+ * @param _needle    Start of UTF-8 needle.
+ * @param _needleEnd End of needle (one-past-last byte).
+ *
+ * @return Pointer to the first match, _utf8 for an empty needle, or NULL if
+ *         there is no match or the needle is invalid UTF-8.
+ */
+const char * utf8_find( const char * _utf8, const char * _utf8End, const char * _needle, const char * _needleEnd );
+
+/**
+ * Set of code points for utf8_find_first_of().
+ *
+ * Membership is tested with an ASCII bitmap and a lead-byte bitmap; only
+ * non-ASCII code points whose lead byte is in the set are decoded and
+ * looked up in the sorted code array.
+ */
+typedef struct utf8_codeset_t
+{
+    uint32_t ascii[4];
+    uint32_t leads[8];
+    const uint32_t * codes;
+    size_t count;
+} utf8_codeset_t;
+
+/**
+ * Initializes a code point set.
+ *
+ * @param _set   Set to initialize.
+ * @param _codes Strictly ascending code points; must outlive the set.
+ * @param _count Number of code points.
+ *
+ * @return _count, or UTF8_UNKNOWN if _codes is unsorted or contains an
+ *         invalid code point.
+ */
+size_t utf8_codeset_init( utf8_codeset_t * const _set, const uint32_t * _codes, size_t _count );
+
+/**
+ * Finds the first code point in [_utf8, _utf8End) that belongs to _set.
+ *
+ * @param _utf8     Start of UTF-8 sequence.
+ * @param _utf8End  End of sequence (one-past-last byte).
+ * @param _set      Code point set.
+ * @param _utf8Code Optional: where to store the matched code point.
+ *
+ * @return Pointer to the matched code point, or NULL if none is found.
+ *         Invalid UTF-8 never matches.
+ */
+const char * utf8_find_first_of( const char * _utf8, const char * _utf8End, const utf8_codeset_t * _set, uint32_t * const _utf8Code );
+
+#define UTF8_JSON_ESCAPE_DEFAULT (0x00)
+#define UTF8_JSON_ESCAPE_ASCII   (0x01)
+
+/**
+ * Returns the number of bytes required to escape [_utf8, _utf8End) as the
+ * contents of a JSON string (without surrounding quotes).
+ *
+ * @param _utf8    Start of UTF-8 sequence.
+ * @param _utf8End End of sequence (one-past-last byte).
+ * @param _flags   UTF8_JSON_ESCAPE_DEFAULT, or UTF8_JSON_ESCAPE_ASCII to
+ *                 escape every non-ASCII code point as \uXXXX.
+ *
+ * @return Required byte count, or UTF8_UNKNOWN on invalid UTF-8.
+ */
+size_t utf8_json_escape_size( const char * _utf8, const char * _utf8End, uint32_t _flags );
+
+/**
+ * Escapes [_utf8, _utf8End) as the contents of a JSON string and validates
+ * it as UTF-8 in the same pass. Quote, backslash and control characters are
+ * escaped; runs that need no escaping are copied in bulk.
+ *
+ * @param _utf8        Start of UTF-8 sequence.
+ * @param _utf8End     End of sequence (one-past-last byte).
+ * @param _flags       UTF8_JSON_ESCAPE_DEFAULT or UTF8_JSON_ESCAPE_ASCII.
+ * @param _out         Output buffer (worst case 6x input size).
+ * @param _outCapacity Output buffer size in bytes.
+ *
+ * @return Number of bytes written, or UTF8_UNKNOWN on invalid UTF-8 or
+ *         insufficient capacity.
+ */
+size_t utf8_json_escape( const char * _utf8, const char * _utf8End, uint32_t _flags, char * const _out, size_t _outCapacity );
+
+/**
+ * Unescapes the contents of a JSON string (without surrounding quotes) to
+ * UTF-8, combining \uXXXX surrogate pairs and validating raw UTF-8.
+ *
+ * @param _json        Start of escaped string.
+ * @param _jsonEnd     End of escaped string (one-past-last byte).
+ * @param _out         Output buffer; input size is always sufficient.
+ * @param _outCapacity Output buffer size in bytes.
+ *
+ * @return Number of bytes written, or UTF8_UNKNOWN on a malformed escape,
+ *         unpaired surrogate, unescaped quote or control character, invalid
+ *         UTF-8 or insufficient capacity.
+ */
+size_t utf8_json_unescape( const char * _json, const char * _jsonEnd, char * const _out, size_t _outCapacity );
+
+/**
+ * Byte range descriptor used by the batch and segmented APIs.
+ */
+typedef struct utf8_span_t
+{
+    const char * data;
+    size_t size;
+} utf8_span_t;
+
+/**
+ * Per-string result of utf8_to_unicodez_batch().
+ */
+typedef struct utf8_batch_result_t
+{
+    size_t offset; // first wchar_t of the string in the arena
+    size_t size; // wchar_t count, or UTF8_UNKNOWN on invalid UTF-8
+} utf8_batch_result_t;
+
+/**
+ * Validates many UTF-8 strings in one call. Runs of up to eight strings of
+ * at most 32 bytes are checked for ASCII together in one test; only a run
+ * containing a non-ASCII byte is validated string by string.
+ *
+ * @param _spans   Array of strings.
+ * @param _count   Number of strings.
+ * @param _offsets Optional: per string, the offset of the first invalid byte
+ *                 (equal to the string size when it is valid).
+ *
+ * @return Number of invalid strings.
+ */
+size_t utf8_validate_batch( const utf8_span_t * _spans, size_t _count, size_t * const _offsets );
+
+/**
+ * Converts many UTF-8 strings to wide characters stored back to back in one
+ * arena (not NUL-terminated). Invalid strings consume no arena space.
+ *
+ * @param _spans         Array of strings.
+ * @param _count         Number of strings.
+ * @param _arena         Output buffer; the total byte size of all strings is
+ *                       always sufficient.
+ * @param _arenaCapacity Output buffer size in wchar_t elements.
+ * @param _results       Per string offset and size in the arena.
+ *
+ * @return Total wchar_t written, or UTF8_UNKNOWN if the arena is too small.
+ */
+size_t utf8_to_unicodez_batch( const utf8_span_t * _spans, size_t _count, wchar_t * const _arena, size_t _arenaCapacity, utf8_batch_result_t * const _results );
+
+/**
+ * Allocator callbacks used by the *_alloc conversions. reallocate is only
+ * used to shrink the result and may be NULL; deallocate may be NULL for
+ * allocators that release memory in bulk.
+ */
+typedef struct utf8_allocator_t
+{
+    void * (*allocate)( size_t _size, void * _ud );
+    void * (*reallocate)( void * _ptr, size_t _oldSize, size_t _newSize, void * _ud );
+    void (*deallocate)( void * _ptr, size_t _size, void * _ud );
+    void * ud;
+} utf8_allocator_t;
+
+/**
+ * Converts a UTF-8 string to a newly allocated NUL-terminated wide-character
+ * string in a single pass (worst-case allocation, then shrink).
+ *
+ * @param _utf8        Input UTF-8 string.
+ * @param _utf8Size    Number of bytes, or UTF8_UNKNOWN for strlen().
+ * @param _allocator   Allocator, or NULL for malloc/realloc/free.
+ * @param _unicodeSize Optional: where to store the wchar_t count (excluding L'\0').
+ *
+ * @return Allocated string, or NULL on invalid UTF-8 or allocation failure.
+ */
+wchar_t * utf8_to_unicode_alloc( const char * _utf8, size_t _utf8Size, const utf8_allocator_t * _allocator, size_t * const _unicodeSize );
+
+/**
+ * Converts a wide-character string to a newly allocated NUL-terminated UTF-8
+ * string in a single pass (worst-case allocation, then shrink).
+ *
+ * @param _unicode     Input wide-character string.
+ * @param _unicodeSize Number of wchar_t elements, or UTF8_UNKNOWN for wcslen().
+ * @param _allocator   Allocator, or NULL for malloc/realloc/free.
+ * @param _utf8Size    Optional: where to store the byte count (excluding '\0').
+ *
+ * @return Allocated string, or NULL on invalid input or allocation failure.
+ */
+char * utf8_from_unicode_alloc( const wchar_t * _unicode, size_t _unicodeSize, const utf8_allocator_t * _allocator, size_t * const _utf8Size );
+
+/**
+ * Bump allocator over a caller-provided buffer, e.g. per-request scratch.
+ */
+typedef struct utf8_arena_t
+{
+    char * buffer;
+    size_t capacity;
+    size_t size;
+    size_t last;
+} utf8_arena_t;
+
+/**
+ * Initializes an arena over [_buffer, _buffer + _capacity). The buffer needs
+ * no particular alignment; blocks are aligned to 16 bytes within it.
+ */
+void utf8_arena_init( utf8_arena_t * const _arena, void * _buffer, size_t _capacity );
+
+/**
+ * Releases every allocation made from the arena.
+ */
+void utf8_arena_reset( utf8_arena_t * const _arena );
+
+/**
+ * Fills _allocator with callbacks that allocate from _arena. The most recent
+ * allocation is shrunk and freed in place.
+ */
+void utf8_arena_allocator( utf8_arena_t * const _arena, utf8_allocator_t * const _allocator );
+
+/**
+ * Validates UTF-8 stored in several segments (e.g. the two halves of a ring
+ * buffer or a chain of network buffers) as one logical string. Sequences
+ * may straddle segment boundaries; empty segments are allowed.
+ *
+ * @param _segments Array of segments, in order.
+ * @param _count    Number of segments.
+ *
+ * @return Logical offset of the first invalid byte, or the total size of all
+ *         segments if the data is valid.
+ */
+size_t utf8_validate_segments( const utf8_span_t * _segments, size_t _count );
+
+/**
+ * Returns the number of wchar_t required to decode segmented UTF-8.
+ *
+ * @param _segments Array of segments, in order.
+ * @param _count    Number of segments.
+ *
+ * @return Required wchar_t count, or UTF8_UNKNOWN on invalid UTF-8.
+ */
+size_t utf8_to_unicode_segments_size( const utf8_span_t * _segments, size_t _count );
+
+/**
+ * Converts segmented UTF-8 to wide characters without copying it into a
+ * contiguous buffer first.
+ *
+ * @param _segments        Array of segments, in order.
+ * @param _count           Number of segments.
+ * @param _unicode         Output buffer.
+ * @param _unicodeCapacity Output buffer size in wchar_t elements.
+ * @return Number of wchar_t written, or UTF8_UNKNOWN on invalid UTF-8.
+ */
+size_t utf8_to_unicode_segments( const utf8_span_t * _segments, size_t _count, wchar_t * const _unicode, size_t _unicodeCapacity );
+
+/**
+ * Encodings recognised by utf8_detect().
+ */
+typedef enum utf8_encoding_e
+{
+    UTF8_ENCODING_UNKNOWN,
+    UTF8_ENCODING_ASCII,
+    UTF8_ENCODING_UTF8,
+    UTF8_ENCODING_UTF16LE,
+    UTF8_ENCODING_UTF16BE,
+    UTF8_ENCODING_WINDOWS1252,
+    UTF8_ENCODING_LATIN1,
+
+    __UTF8_ENCODING_COUNT__
+} utf8_encoding_e;
+
+/**
+ * Detailed result of utf8_detect().
+ */
+typedef struct utf8_detect_t
+{
+    utf8_encoding_e ranking[__UTF8_ENCODING_COUNT__ - 1]; // candidates, most likely first
+    uint32_t confidence[__UTF8_ENCODING_COUNT__]; // 0..100, indexed by utf8_encoding_e
+    size_t bom_size; // bytes of byte order mark at the start, 0 if none
+    size_t utf8_invalid_offset; // first byte that is not valid UTF-8, or the sample size
+    size_t nul_even; // NUL bytes at even offsets
+    size_t nul_odd; // NUL bytes at odd offsets
+    size_t high_bytes; // bytes >= 0x80
+    size_t c1_bytes; // bytes in 0x80..0x9F
+} utf8_detect_t;
+
+/**
+ * Guesses the encoding of a text sample in a single pass. A byte order mark
+ * wins outright; otherwise the guess is based on NUL byte parity, UTF-8
+ * validity and the use of the C1 range. A multibyte sequence cut off by the
+ * end of the sample is not treated as invalid.
+ *
+ * @param _data   Sample bytes.
+ * @param _size   Sample size in bytes.
+ * @param _result Optional: scores, ranking and the counters behind them.
+ *
+ * @return Most likely encoding, or UTF8_ENCODING_UNKNOWN if nothing fits.
+ */
+utf8_encoding_e utf8_detect( const char * _data, size_t _size, utf8_detect_t * const _result );
+
+/**
+ * Single-byte code page: bytes 0x00..0x7F are ASCII, bytes 0x80..0xFF map
+ * through a 128-entry table. Build custom pages with utf8_codepage_init().
+ */
+typedef struct utf8_codepage_t
+{
+    uint16_t high[128]; // code point of bytes 0x80..0xFF, 0 if unmapped
+    uint32_t encoded[128]; // UTF-8 of each high byte in the low bytes, length in the top byte
+    uint32_t reverse[128]; // (code point << 8) | byte, ascending
+    size_t reverse_count;
+} utf8_codepage_t;
+
+extern const utf8_codepage_t utf8_codepage_windows1252;
+extern const utf8_codepage_t utf8_codepage_latin1;
+extern const utf8_codepage_t utf8_codepage_koi8r;
+extern const utf8_codepage_t utf8_codepage_iso8859_5;
+
+/**
+ * Builds a code page from the code points of its high half.
+ *
+ * @param _codepage Code page to fill.
+ * @param _high     128 code points for bytes 0x80..0xFF; 0 marks an unmapped byte.
+ *
+ * @return Number of mapped bytes, or UTF8_UNKNOWN if an entry is a surrogate.
+ */
+size_t utf8_codepage_init( utf8_codepage_t * const _codepage, const uint16_t * _high );
+
+/**
+ * Returns the number of UTF-8 bytes required to convert code page text.
+ *
+ * @param _data     Code page text.
+ * @param _dataSize Size in bytes, or UTF8_UNKNOWN for strlen().
+ * @param _codepage Code page.
+ *
+ * @return Required UTF-8 byte count, or UTF8_UNKNOWN on an unmapped byte.
+ */
+size_t utf8_from_codepage_size( const char * _data, size_t _dataSize, const utf8_codepage_t * _codepage );
+
+/**
+ * Converts code page text to UTF-8. ASCII runs are copied in bulk.
+ *
+ * @param _data         Code page text.
+ * @param _dataSize     Size in bytes, or UTF8_UNKNOWN for strlen().
+ * @param _codepage     Code page.
+ * @param _utf8         Output buffer.
+ * @param _utf8Capacity Output buffer size in bytes.
+ *
+ * @return Number of bytes written, or UTF8_UNKNOWN on an unmapped byte or
+ *         insufficient capacity.
+ */
+size_t utf8_from_codepage( const char * _data, size_t _dataSize, const utf8_codepage_t * _codepage, char * const _utf8, size_t _utf8Capacity );
+
+/**
+ * Converts UTF-8 to code page text (one byte per code point).
+ *
+ * @param _utf8         UTF-8 text.
+ * @param _utf8Size     Size in bytes, or UTF8_UNKNOWN for strlen().
+ * @param _codepage     Code page.
+ * @param _data         Output buffer.
+ * @param _dataCapacity Output buffer size in bytes.
+ *
+ * @return Number of bytes written, or UTF8_UNKNOWN on invalid UTF-8, a code
+ *         point the code page cannot represent, or insufficient capacity.
+ */
+size_t utf8_to_codepage( const char * _utf8, size_t _utf8Size, const utf8_codepage_t * _codepage, char * const _data, size_t _dataCapacity );
+
+#define UTF8_CESU8_DEFAULT  (0x00)
+#define UTF8_CESU8_MODIFIED (0x01)
+
+/**
+ * Returns the number of UTF-8 bytes required to convert CESU-8.
+ *
+ * @param _cesu8    Start of CESU-8 sequence.
+ * @param _cesu8End End of sequence (one-past-last byte).
+ * @param _flags    UTF8_CESU8_DEFAULT, or UTF8_CESU8_MODIFIED for Java
+ *                  Modified UTF-8 (NUL encoded as C0 80, raw NUL rejected).
+ *
+ * @return Required byte count, or UTF8_UNKNOWN on invalid input.
+ */
+size_t utf8_from_cesu8_size( const char * _cesu8, const char * _cesu8End, uint32_t _flags );
+
+/**
+ * Converts CESU-8 (supplementary code points as two 3-byte surrogates) to
+ * UTF-8, validating it in the same pass. Runs that are already valid UTF-8
+ * are copied in bulk. Unpaired surrogates and 4-byte sequences are invalid.
+ *
+ * @param _cesu8        Start of CESU-8 sequence.
+ * @param _cesu8End     End of sequence (one-past-last byte).
+ * @param _flags        UTF8_CESU8_DEFAULT or UTF8_CESU8_MODIFIED.
+ * @param _utf8         Output buffer (never larger than the input).
+ * @param _utf8Capacity Output buffer size in bytes.
+ *
+ * @return Number of bytes written, or UTF8_UNKNOWN on invalid input or
+ *         insufficient capacity.
+ */
+size_t utf8_from_cesu8( const char * _cesu8, const char * _cesu8End, uint32_t _flags, char * const _utf8, size_t _utf8Capacity );
+
+/**
+ * Returns the number of CESU-8 bytes required to convert UTF-8.
+ *
+ * @param _utf8    Start of UTF-8 sequence.
+ * @param _utf8End End of sequence (one-past-last byte).
+ * @param _flags   UTF8_CESU8_DEFAULT or UTF8_CESU8_MODIFIED.
+ *
+ * @return Required byte count, or UTF8_UNKNOWN on invalid UTF-8.
+ */
+size_t utf8_to_cesu8_size( const char * _utf8, const char * _utf8End, uint32_t _flags );
+
+/**
+ * Converts UTF-8 to CESU-8, or to Modified UTF-8 with UTF8_CESU8_MODIFIED.
+ * Runs without supplementary code points (or NUL) are copied in bulk.
+ *
+ * @param _utf8          Start of UTF-8 sequence.
+ * @param _utf8End       End of sequence (one-past-last byte).
+ * @param _flags         UTF8_CESU8_DEFAULT or UTF8_CESU8_MODIFIED.
+ * @param _cesu8         Output buffer (worst case 2x input size).
+ * @param _cesu8Capacity Output buffer size in bytes.
+ *
+ * @return Number of bytes written, or UTF8_UNKNOWN on invalid UTF-8 or
+ *         insufficient capacity.
+ */
+size_t utf8_to_cesu8( const char * _utf8, const char * _utf8End, uint32_t _flags, char * const _cesu8, size_t _cesu8Capacity );
+
+/**
+ * Categories of unsafe input handled by utf8_sanitize().
+ */
+typedef enum utf8_sanitize_category_e
+{
+    UTF8_SANITIZE_INVALID, // each byte of ill-formed UTF-8
+    UTF8_SANITIZE_CONTROL, // C0 except TAB, LF and CR; DEL; C1
+    UTF8_SANITIZE_LINE_BREAK, // LF, CR, U+2028, U+2029
+    UTF8_SANITIZE_BIDI, // U+061C, U+200E, U+200F, U+202A..U+202E, U+2066..U+2069
+    UTF8_SANITIZE_NONCHARACTER, // U+FDD0..U+FDEF and U+xxFFFE, U+xxFFFF
+
+    __UTF8_SANITIZE_CATEGORY_COUNT__
+} utf8_sanitize_category_e;
+
+typedef enum utf8_sanitize_action_e
+{
+    UTF8_SANITIZE_KEEP,
+    UTF8_SANITIZE_REPLACE, // U+FFFD
+    UTF8_SANITIZE_DROP,
+    UTF8_SANITIZE_ESCAPE // \xHH for bytes and ASCII, \uXXXX or \UXXXXXXXX otherwise; a backslash is doubled
+} utf8_sanitize_action_e;
+
+/**
+ * Action per category for utf8_sanitize().
+ */
+typedef struct utf8_sanitize_t
+{
+    utf8_sanitize_action_e actions[__UTF8_SANITIZE_CATEGORY_COUNT__];
+} utf8_sanitize_t;
+
+/**
+ * Sets the same action for every category.
+ *
+ * @param _config Configuration to fill.
+ * @param _action Action for all categories.
+ */
+void utf8_sanitize_init( utf8_sanitize_t * const _config, utf8_sanitize_action_e _action );
+
+/**
+ * Returns the number of bytes utf8_sanitize() will produce.
+ *
+ * @param _utf8    Start of input sequence.
+ * @param _utf8End End of input sequence (one-past-last byte).
+ * @param _config  Action per category.
+ *
+ * @return Required byte count.
+ */
+size_t utf8_sanitize_size( const char * _utf8, const char * _utf8End, const utf8_sanitize_t * _config );
+
+/**
+ * Repairs invalid UTF-8 and filters control, line break, bidi and
+ * noncharacter code points in one pass. Runs of safe input are copied in
+ * bulk; printable ASCII is skipped 16 bytes at a time.
+ *
+ * @param _utf8        Start of input sequence.
+ * @param _utf8End     End of input sequence (one-past-last byte).
+ * @param _config      Action per category.
+ * @param _out         Output buffer (worst case 4x input size).
+ * @param _outCapacity Output buffer size in bytes.
+ *
+ * @return Number of bytes written, or UTF8_UNKNOWN on insufficient capacity.
+ */
+size_t utf8_sanitize( const char * _utf8, const char * _utf8End, const utf8_sanitize_t * _config, char * const _out, size_t _outCapacity );
+
+/**
+ * Instruction set paths for the vectorised kernels.
+ */
+typedef enum utf8_isa_e
+{
+    UTF8_ISA_AUTO,
+    UTF8_ISA_SCALAR,
+    UTF8_ISA_SSE2,
+    UTF8_ISA_AVX2,
+    UTF8_ISA_AVX512,
+
+    __UTF8_ISA_COUNT__
+} utf8_isa_e;
+
+/**
+ * Checks whether a path is compiled in and supported by this CPU.
+ *
+ * @param _isa Instruction set path; UTF8_ISA_AUTO is always supported.
+ *
+ * @return 1 if the path can be selected, 0 otherwise.
+ */
+int utf8_isa_supported( utf8_isa_e _isa );
+
+/**
+ * Forces a kernel path, e.g. to benchmark or test every path on one
+ * machine. The selection is a single atomic pointer store and may be
+ * changed at any time from any thread.
+ *
+ * @param _isa Instruction set path, or UTF8_ISA_AUTO to go back to the
+ *             default (the UTF8_ISA environment variable if it names a
+ *             supported path, otherwise the best supported path).
+ *
+ * @return The active path after the call; unchanged if _isa is unsupported.
+ */
+utf8_isa_e utf8_isa_select( utf8_isa_e _isa );
+
+/**
+ * Returns the active kernel path, resolving it on first use.
+ *
+ * @return Active instruction set path (never UTF8_ISA_AUTO).
+ */
+utf8_isa_e utf8_isa_active( void );
+
+/**
+ * Returns the name of a path as accepted by the UTF8_ISA environment
+ * variable: "auto", "scalar", "sse2", "avx2" or "avx512".
+ *
+ * @param _isa Instruction set path.
+ *
+ * @return Static string, or NULL for an out-of-range value.
+ */
+const char * utf8_isa_name( utf8_isa_e _isa );
+
+#ifdef UTF8_ENABLE_STATS
+/**
+ * Instrumentation, compiled in only when UTF8_ENABLE_STATS is defined
+ * (CMake option UTF8_ENABLE_STATS). Without it the hooks compile to nothing.
+ * Only calls made by the application are counted, not the library's own use
+ * of these functions (search, batch and allocating conversions).
+ */
+typedef enum utf8_stats_function_e
+{
+    UTF8_STATS_VALIDATE,
+    UTF8_STATS_REPLACE_INVALID,
+    UTF8_STATS_TO_UNICODE,
+    UTF8_STATS_FROM_UNICODE,
+
+    __UTF8_STATS_FUNCTION_COUNT__
+} utf8_stats_function_e;
+
+/**
+ * Path that settled a call.
+ */
+typedef enum utf8_stats_path_e
+{
+    UTF8_STATS_PATH_SMALL, // overlapping-load check of a short pure-ASCII string
+    UTF8_STATS_PATH_ASCII, // vector ASCII kernel alone (validation only)
+    UTF8_STATS_PATH_SCALAR, // code point decoder or encoder
+
+    __UTF8_STATS_PATH_COUNT__
+} utf8_stats_path_e;
+
+/**
+ * Per-function counters. bytes counts UTF-8 bytes consumed (validation,
+ * replacement, decoding) or produced (encoding); ascii_bytes counts the
+ * ASCII among them and ascii_calls the calls whose data was pure ASCII.
+ * paths counts calls by the path that settled them.
+ */
+typedef struct utf8_stats_counters_t
+{
+    uint64_t calls;
+    uint64_t bytes;
+    uint64_t errors;
+    uint64_t ascii_bytes;
+    uint64_t ascii_calls;
+    uint64_t paths[__UTF8_STATS_PATH_COUNT__];
+} utf8_stats_counters_t;
+
+typedef struct utf8_stats_t
+{
+    utf8_stats_counters_t functions[__UTF8_STATS_FUNCTION_COUNT__];
+} utf8_stats_t;
+
+/**
+ * Hooks called on the calling thread: begin on entry to an instrumented
+ * function, end when it returns, e.g. to time it. Either may be NULL.
+ */
+typedef struct utf8_stats_hooks_t
+{
+    void (*begin)( utf8_stats_function_e _function, void * _ud );
+    void (*end)( utf8_stats_function_e _function, size_t _bytes, size_t _asciiBytes, int _error, void * _ud );
+    void * ud;
+} utf8_stats_hooks_t;
+
+/**
+ * Totals the counters of every thread that has called an instrumented
+ * function, including threads that have since exited.
+ */
+void utf8_stats_get( utf8_stats_t * const _stats );
+
+/**
+ * Clears the counters of every thread. Calls running concurrently on other
+ * threads may still be counted afterwards.
+ */
+void utf8_stats_reset( void );
+
+/**
+ * Adds _stats into _total, e.g. to combine snapshots taken over time.
+ */
+void utf8_stats_accumulate( utf8_stats_t * const _total, const utf8_stats_t * _stats );
+
+/**
+ * Installs process-wide hooks (NULL to remove). _hooks is not copied and
+ * must stay valid while any call may still be using it.
+ */
+void utf8_stats_set_hooks( const utf8_stats_hooks_t * _hooks );
+#endif
+
 #endif
\ No newline at end of file
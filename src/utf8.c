@@ -1,10 +1,7 @@
-#include "utf8/utf8.h"
+#include "utf8_internal.h"
+
+#include <string.h>
 
-//////////////////////////////////////////////////////////////////////////
-#define UTF8_REPLACEMENT_CHARACTER (0xFFFD)
-#define UTF8_SURROGATE_LO          (0xD800)
-#define UTF8_SURROGATE_HI          (0xDFFF)
-#define UTF8_MAX_CODE_POINT        (0x10FFFF)
 //////////////////////////////////////////////////////////////////////////
 static size_t __utf8_code_size( uint32_t _code )
 {
@@ -34,6 +31,11 @@ static size_t __utf8_code_size( uint32_t _code )
 //////////////////////////////////////////////////////////////////////////
 size_t utf8_from_unicodez_size( const wchar_t * _unicode, size_t _unicodeSize )
 {
+    if( _unicodeSize == UTF8_UNKNOWN )
+    {
+        _unicodeSize = wcslen( _unicode );
+    }
+
     size_t utf8Size = 0;
 
     for( const wchar_t 
@@ -138,14 +140,32 @@ static size_t __convert_unicode_to_utf8( uint32_t _code, char * const _utf8, siz
     return UTF8_UNKNOWN;
 }
 //////////////////////////////////////////////////////////////////////////
-size_t utf8_from_unicodez( const wchar_t * _unicode, size_t _unicodeSize, char * const _utf8, size_t _utf8Capacity )
+size_t __utf8_from_unicodez( const wchar_t * _unicode, size_t _unicodeSize, char * const _utf8, size_t _utf8Capacity, utf8_trace_t * const _trace )
 {
     if( _utf8Capacity == 0 )
     {
         return 0;
     }
 
+    if( _unicodeSize == UTF8_UNKNOWN )
+    {
+        _unicodeSize = wcslen( _unicode );
+    }
+
+    if( _unicodeSize <= UTF8_SMALL_STRING_SIZE && _unicodeSize <= _utf8Capacity && __utf8_small_wide_is_ascii( _unicode, _unicodeSize ) == 1 )
+    {
+        for( size_t index = 0; index != _unicodeSize; ++index )
+        {
+            _utf8[index] = (char)_unicode[index];
+        }
+
+        __utf8_trace_set( _trace, _utf8 + _unicodeSize, _unicodeSize, 1 );
+
+        return _unicodeSize;
+    }
+
     size_t utf8Size = 0;
+    size_t asciiBytes = 0;
 
     for( const wchar_t
         * it = _unicode,
@@ -159,12 +179,34 @@ size_t utf8_from_unicodez( const wchar_t * _unicode, size_t _unicodeSize, char *
 
         if( codeSize == UTF8_UNKNOWN )
         {
+            __utf8_trace_set( _trace, _utf8 + utf8Size, asciiBytes, 0 );
+
             return UTF8_UNKNOWN;
         }
 
         utf8Size += codeSize;
+        asciiBytes += codeSize == 1;
     }
 
+    __utf8_trace_set( _trace, _utf8 + utf8Size, asciiBytes, 0 );
+
+    return utf8Size;
+}
+//////////////////////////////////////////////////////////////////////////
+size_t utf8_from_unicodez( const wchar_t * _unicode, size_t _unicodeSize, char * const _utf8, size_t _utf8Capacity )
+{
+    if( _utf8Capacity == 0 )
+    {
+        return 0;
+    }
+
+    UTF8_STATS_BEGIN( UTF8_STATS_FROM_UNICODE );
+
+    utf8_trace_t trace;
+    size_t utf8Size = __utf8_from_unicodez( _unicode, _unicodeSize, _utf8, _utf8Capacity, &trace );
+
+    UTF8_STATS_RECORD( UTF8_STATS_FROM_UNICODE, _utf8, trace.end, trace.ascii, trace.small == 1 ? UTF8_STATS_PATH_SMALL : UTF8_STATS_PATH_SCALAR, utf8Size == UTF8_UNKNOWN );
+
     return utf8Size;
 }
 //////////////////////////////////////////////////////////////////////////
@@ -175,7 +217,10 @@ size_t utf8_from_unicode( const wchar_t * _unicode, char * const _utf8, size_t _
         return 0;
     }
 
+    UTF8_STATS_BEGIN( UTF8_STATS_FROM_UNICODE );
+
     size_t utf8Size = 0;
+    size_t asciiBytes = 0;
 
     for( const wchar_t * p = _unicode; *p != L'\0'; ++p )
     {
@@ -185,12 +230,17 @@ size_t utf8_from_unicode( const wchar_t * _unicode, char * const _utf8, size_t _
 
         if( codeSize == UTF8_UNKNOWN )
         {
+            UTF8_STATS_RECORD( UTF8_STATS_FROM_UNICODE, _utf8, _utf8 + utf8Size, asciiBytes, UTF8_STATS_PATH_SCALAR, 1 );
+
             return UTF8_UNKNOWN;
         }
 
         utf8Size += codeSize;
+        asciiBytes += codeSize == 1;
     }
 
+    UTF8_STATS_RECORD( UTF8_STATS_FROM_UNICODE, _utf8, _utf8 + utf8Size, asciiBytes, UTF8_STATS_PATH_SCALAR, 0 );
+
     return utf8Size;
 }
 //////////////////////////////////////////////////////////////////////////
@@ -216,8 +266,40 @@ static size_t __unicode_code_size( uint8_t _code )
     return UTF8_UNKNOWN;
 }
 //////////////////////////////////////////////////////////////////////////
+static const char * __utf8_terminated_code_end( const char * _utf8 )
+{
+    // bytes are checked one at a time so a NUL ends the scan before
+    // anything past the terminator is read
+    size_t codeSize = __unicode_code_size( (uint8_t)*_utf8 );
+
+    if( codeSize == UTF8_UNKNOWN )
+    {
+        return NULL;
+    }
+
+    for( size_t index = 1; index != codeSize; ++index )
+    {
+        if( ((uint8_t)_utf8[index] & 0xC0) != 0x80 )
+        {
+            return NULL;
+        }
+    }
+
+    return _utf8 + codeSize;
+}
+//////////////////////////////////////////////////////////////////////////
 size_t utf8_to_unicodez_size( const char * _utf8, size_t _utf8Size )
 {
+    if( _utf8Size == UTF8_UNKNOWN )
+    {
+        _utf8Size = strlen( _utf8 );
+    }
+
+    if( _utf8Size <= UTF8_SMALL_STRING_SIZE && __utf8_small_is_ascii( _utf8, _utf8Size ) == 1 )
+    {
+        return _utf8Size;
+    }
+
     size_t unicodeSize = 0;
 
     for( const char
@@ -225,21 +307,24 @@ size_t utf8_to_unicodez_size( const char * _utf8, size_t _utf8Size )
         *it_end = _utf8 + _utf8Size;
         it != it_end; )
     {
-        uint8_t code = (uint8_t)*it;
+        size_t ascii = __utf8_ascii_prefix( it, it_end );
 
-        size_t codeSize = __unicode_code_size( code );
+        it += ascii;
+        unicodeSize += ascii;
 
-        if( codeSize == UTF8_UNKNOWN )
+        if( it == it_end )
         {
-            return UTF8_UNKNOWN;
+            break;
         }
 
-        if( it + codeSize > it_end )
+        const char * it_next = utf8_next_code( it, it_end, NULL );
+
+        if( it_next == NULL )
         {
             return UTF8_UNKNOWN;
         }
 
-        it += codeSize;
+        it = it_next;
 
         ++unicodeSize;
     }
@@ -253,96 +338,95 @@ size_t utf8_to_unicode_size( const char * _utf8 )
 
     for( const char * it = _utf8; *it != '\0'; )
     {
-        uint8_t code = (uint8_t)*it;
+        const char * it_end = __utf8_terminated_code_end( it );
 
-        size_t codeSize = __unicode_code_size( code );
-
-        if( codeSize == UTF8_UNKNOWN )
+        if( it_end == NULL || utf8_next_code( it, it_end, NULL ) != it_end )
         {
             return UTF8_UNKNOWN;
         }
 
-        it += codeSize;
+        it = it_end;
 
         ++unicodeSize;
     }
 
     return unicodeSize;
 }
-
 //////////////////////////////////////////////////////////////////////////
-static const char * __convert_utf8_to_unicode( const char * _utf8, wchar_t * const _unicode, size_t _unicodeSize )
+size_t __utf8_to_unicodez( const char * _utf8, size_t _utf8Size, wchar_t * const _unicode, size_t _unicodeCapacity, utf8_trace_t * const _trace )
 {
-    uint8_t c0 = (uint8_t)*_utf8++;
-
-    if( (c0 & 0x80) == 0 )
+    if( _unicodeCapacity == 0 )
     {
-        _unicode[_unicodeSize] = (wchar_t)c0;
-
-        return _utf8;
+        return 0;
     }
-    else if( (c0 & 0xE0) == 0xC0 )
-    {
-        uint8_t c1 = (uint8_t)*_utf8++;
 
-        _unicode[_unicodeSize] = (wchar_t)((c0 & 0x1F) << 6) | (c1 & 0x3F);
-
-        return _utf8;
-    }
-    else if( (c0 & 0xF0) == 0xE0 )
+    if( _utf8Size == UTF8_UNKNOWN )
     {
-        uint8_t c1 = (uint8_t)*_utf8++;
-        uint8_t c2 = (uint8_t)*_utf8++;
-
-        _unicode[_unicodeSize] = (wchar_t)((c0 & 0x0F) << 12) | ((c1 & 0x3F) << 6) | (c2 & 0x3F);
-
-        return _utf8;
+        _utf8Size = strlen( _utf8 );
     }
-    else if( (c0 & 0xF8) == 0xF0 )
-    {
-        uint8_t c1 = (uint8_t)*_utf8++;
-        uint8_t c2 = (uint8_t)*_utf8++;
-        uint8_t c3 = (uint8_t)*_utf8++;
 
-        _unicode[_unicodeSize] = (wchar_t)((c0 & 0x07) << 18) | ((c1 & 0x3F) << 12) | ((c2 & 0x3F) << 6) | (c3 & 0x3F);
+    if( _utf8Size <= UTF8_SMALL_STRING_SIZE && _utf8Size <= _unicodeCapacity && __utf8_small_is_ascii( _utf8, _utf8Size ) == 1 )
+    {
+        for( size_t index = 0; index != _utf8Size; ++index )
+        {
+            _unicode[index] = (wchar_t)_utf8[index];
+        }
 
-        return _utf8;
-    }
+        __utf8_trace_set( _trace, _utf8 + _utf8Size, _utf8Size, 1 );
 
-    return NULL;
-}
-//////////////////////////////////////////////////////////////////////////
-size_t utf8_to_unicodez( const char * _utf8, size_t _utf8Size, wchar_t * const _unicode, size_t _unicodeCapacity )
-{
-    if( _unicodeCapacity == 0 )
-    {
-        return 0;
+        return _utf8Size;
     }
 
     size_t unicodeSize = 0;
+    size_t asciiBytes = 0;
 
-    for( const char 
-        * it = _utf8,
-        *it_end = _utf8 + _utf8Size;
-        it != it_end; )
+    const char * it = _utf8;
+    const char * it_end = _utf8 + _utf8Size;
+
+    for( ; it != it_end; )
     {
         if( unicodeSize >= _unicodeCapacity )
         {
             break;
         }
 
-        const char * it_next = __convert_utf8_to_unicode( it, _unicode, unicodeSize );
+        uint32_t code;
+        const char * it_next = utf8_next_code( it, it_end, &code );
 
         if( it_next == NULL )
         {
+            __utf8_trace_set( _trace, it, asciiBytes, 0 );
+
             return UTF8_UNKNOWN;
         }
 
+        _unicode[unicodeSize] = (wchar_t)code;
+        asciiBytes += code < 0x80;
+
         it = it_next;
 
         ++unicodeSize;
     }
 
+    __utf8_trace_set( _trace, it, asciiBytes, 0 );
+
+    return unicodeSize;
+}
+//////////////////////////////////////////////////////////////////////////
+size_t utf8_to_unicodez( const char * _utf8, size_t _utf8Size, wchar_t * const _unicode, size_t _unicodeCapacity )
+{
+    if( _unicodeCapacity == 0 )
+    {
+        return 0;
+    }
+
+    UTF8_STATS_BEGIN( UTF8_STATS_TO_UNICODE );
+
+    utf8_trace_t trace;
+    size_t unicodeSize = __utf8_to_unicodez( _utf8, _utf8Size, _unicode, _unicodeCapacity, &trace );
+
+    UTF8_STATS_RECORD( UTF8_STATS_TO_UNICODE, _utf8, trace.end, trace.ascii, trace.small == 1 ? UTF8_STATS_PATH_SMALL : UTF8_STATS_PATH_SCALAR, unicodeSize == UTF8_UNKNOWN );
+
     return unicodeSize;
 }
 //////////////////////////////////////////////////////////////////////////
@@ -353,27 +437,40 @@ size_t utf8_to_unicode( const char * _utf8, wchar_t * const _unicode, size_t _un
         return 0;
     }
 
+    UTF8_STATS_BEGIN( UTF8_STATS_TO_UNICODE );
+
     size_t unicodeSize = 0;
+    size_t asciiBytes = 0;
 
-    for( const char * it = _utf8; *it != '\0'; )
+    const char * it = _utf8;
+
+    for( ; *it != '\0'; )
     {
         if( unicodeSize >= _unicodeCapacity )
         {
             break;
         }
 
-        const char * it_next = __convert_utf8_to_unicode( it, _unicode, unicodeSize );
+        uint32_t code;
+        const char * it_end = __utf8_terminated_code_end( it );
 
-        if( it_next == NULL )
+        if( it_end == NULL || utf8_next_code( it, it_end, &code ) != it_end )
         {
+            UTF8_STATS_RECORD( UTF8_STATS_TO_UNICODE, _utf8, it, asciiBytes, UTF8_STATS_PATH_SCALAR, 1 );
+
             return UTF8_UNKNOWN;
         }
 
-        it = it_next;
+        _unicode[unicodeSize] = (wchar_t)code;
+        asciiBytes += code < 0x80;
+
+        it = it_end;
 
         ++unicodeSize;
     }
 
+    UTF8_STATS_RECORD( UTF8_STATS_TO_UNICODE, _utf8, it, asciiBytes, UTF8_STATS_PATH_SCALAR, 0 );
+
     return unicodeSize;
 }
 //////////////////////////////////////////////////////////////////////////
@@ -522,23 +619,59 @@ const char * utf8_next_code( const char * _utf8, const char * _utf8End, uint32_t
     return (const char *)p;
 }
 //////////////////////////////////////////////////////////////////////////
-const char * utf8_validate( const char * _utf8, const char * _utf8End )
+const char * __utf8_validate( const char * _utf8, const char * _utf8End, utf8_trace_t * const _trace )
 {
+    if( _utf8 < _utf8End && _utf8End - _utf8 <= UTF8_SMALL_STRING_SIZE && __utf8_small_is_ascii( _utf8, (size_t)(_utf8End - _utf8) ) == 1 )
+    {
+        __utf8_trace_set( _trace, _utf8End, (size_t)(_utf8End - _utf8), 1 );
+
+        return _utf8End;
+    }
+
+    size_t asciiBytes = 0;
+
     for( const char * p = _utf8; p < _utf8End; )
     {
+        size_t ascii = __utf8_ascii_prefix( p, _utf8End );
+
+        p += ascii;
+        asciiBytes += ascii;
+
+        if( p == _utf8End )
+        {
+            break;
+        }
+
         const char * next = utf8_next_code( p, _utf8End, NULL );
 
         if( next == NULL )
         {
+            __utf8_trace_set( _trace, p, asciiBytes, 0 );
+
             return p;
         }
 
         p = next;
     }
 
+    __utf8_trace_set( _trace, _utf8End, asciiBytes, 0 );
+
     return _utf8End;
 }
 //////////////////////////////////////////////////////////////////////////
+const char * utf8_validate( const char * _utf8, const char * _utf8End )
+{
+    UTF8_STATS_BEGIN( UTF8_STATS_VALIDATE );
+
+    utf8_trace_t trace;
+    const char * invalid = __utf8_validate( _utf8, _utf8End, &trace );
+
+    // the ASCII kernel alone settled the call when it saw every byte
+    UTF8_STATS_RECORD( UTF8_STATS_VALIDATE, _utf8, invalid, trace.ascii, trace.small == 1 ? UTF8_STATS_PATH_SMALL : invalid == _utf8End && trace.ascii == (size_t)(invalid - _utf8) ? UTF8_STATS_PATH_ASCII : UTF8_STATS_PATH_SCALAR, invalid != _utf8End );
+
+    return invalid;
+}
+//////////////////////////////////////////////////////////////////////////
 static char * __append_code_point( char * _out, uint32_t _cp )
 {
     if( _cp < 0x80 )
@@ -569,8 +702,13 @@ static char * __append_code_point( char * _out, uint32_t _cp )
 //////////////////////////////////////////////////////////////////////////
 const char * utf8_replace_invalid( const char * _utf8, const char * _utf8End, char * const _utf8Out )
 {
+    UTF8_STATS_BEGIN( UTF8_STATS_REPLACE_INVALID );
+
     char * uft8Work = _utf8Out;
 
+    size_t replaced = 0;
+    size_t asciiBytes = 0;
+
     for( const char * p = _utf8; p != _utf8End; )
     {
         uint32_t code;
@@ -579,6 +717,7 @@ const char * utf8_replace_invalid( const char * _utf8, const char * _utf8End, ch
         if( next != NULL )
         {
             uft8Work = __append_code_point( uft8Work, code );
+            asciiBytes += code < 0x80;
 
             p = next;
         }
@@ -586,10 +725,13 @@ const char * utf8_replace_invalid( const char * _utf8, const char * _utf8End, ch
         {
             uft8Work = __append_code_point( uft8Work, UTF8_REPLACEMENT_CHARACTER );
 
+            ++replaced;
             ++p;
         }
     }
 
+    UTF8_STATS_RECORD( UTF8_STATS_REPLACE_INVALID, _utf8, _utf8End, asciiBytes, UTF8_STATS_PATH_SCALAR, replaced != 0 );
+
     return uft8Work;
 }
-//////////////////////////////////////////////////////////////////////////
\ No newline at end of file
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,254 @@
+#include "utf8_internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////
+#define UTF8_ARENA_ALIGNMENT (16)
+//////////////////////////////////////////////////////////////////////////
+static void * __utf8_default_allocate( size_t _size, void * _ud )
+{
+    (void)_ud;
+
+    return malloc( _size );
+}
+//////////////////////////////////////////////////////////////////////////
+static void * __utf8_default_reallocate( void * _ptr, size_t _oldSize, size_t _newSize, void * _ud )
+{
+    (void)_oldSize;
+    (void)_ud;
+
+    return realloc( _ptr, _newSize );
+}
+//////////////////////////////////////////////////////////////////////////
+static void __utf8_default_deallocate( void * _ptr, size_t _size, void * _ud )
+{
+    (void)_size;
+    (void)_ud;
+
+    free( _ptr );
+}
+//////////////////////////////////////////////////////////////////////////
+static const utf8_allocator_t __utf8_default_allocator = {
+    &__utf8_default_allocate,
+    &__utf8_default_reallocate,
+    &__utf8_default_deallocate,
+    NULL
+};
+//////////////////////////////////////////////////////////////////////////
+static void * __utf8_shrink( const utf8_allocator_t * _allocator, void * _ptr, size_t _oldSize, size_t _newSize )
+{
+    if( _allocator->reallocate == NULL || _newSize == _oldSize )
+    {
+        return _ptr;
+    }
+
+    void * shrunk = (*_allocator->reallocate)( _ptr, _oldSize, _newSize, _allocator->ud );
+
+    // a failed shrink still leaves the original block valid
+    return shrunk != NULL ? shrunk : _ptr;
+}
+//////////////////////////////////////////////////////////////////////////
+wchar_t * utf8_to_unicode_alloc( const char * _utf8, size_t _utf8Size, const utf8_allocator_t * _allocator, size_t * const _unicodeSize )
+{
+    if( _utf8 == NULL )
+    {
+        return NULL;
+    }
+
+    if( _allocator == NULL )
+    {
+        _allocator = &__utf8_default_allocator;
+    }
+
+    if( _utf8Size == UTF8_UNKNOWN )
+    {
+        _utf8Size = strlen( _utf8 );
+    }
+
+    // a UTF-8 string never decodes to more wchar_t than it has bytes
+    if( _utf8Size >= ((size_t)-1) / sizeof( wchar_t ) )
+    {
+        return NULL;
+    }
+
+    size_t capacity = _utf8Size + 1;
+    size_t capacityBytes = capacity * sizeof( wchar_t );
+
+    wchar_t * unicode = (wchar_t *)(*_allocator->allocate)( capacityBytes, _allocator->ud );
+
+    if( unicode == NULL )
+    {
+        return NULL;
+    }
+
+    size_t unicodeSize = _utf8Size == 0 ? 0 : __utf8_to_unicodez( _utf8, _utf8Size, unicode, capacity, NULL );
+
+    if( unicodeSize == UTF8_UNKNOWN )
+    {
+        if( _allocator->deallocate != NULL )
+        {
+            (*_allocator->deallocate)( unicode, capacityBytes, _allocator->ud );
+        }
+
+        return NULL;
+    }
+
+    unicode[unicodeSize] = L'\0';
+
+    unicode = (wchar_t *)__utf8_shrink( _allocator, unicode, capacityBytes, (unicodeSize + 1) * sizeof( wchar_t ) );
+
+    if( _unicodeSize != NULL )
+    {
+        *_unicodeSize = unicodeSize;
+    }
+
+    return unicode;
+}
+//////////////////////////////////////////////////////////////////////////
+char * utf8_from_unicode_alloc( const wchar_t * _unicode, size_t _unicodeSize, const utf8_allocator_t * _allocator, size_t * const _utf8Size )
+{
+    if( _unicode == NULL )
+    {
+        return NULL;
+    }
+
+    if( _allocator == NULL )
+    {
+        _allocator = &__utf8_default_allocator;
+    }
+
+    if( _unicodeSize == UTF8_UNKNOWN )
+    {
+        _unicodeSize = wcslen( _unicode );
+    }
+
+    // UTF-16 wchar_t units need at most 3 bytes each, UTF-32 ones at most 4
+    const size_t maxCodeSize = sizeof( wchar_t ) == 2 ? 3 : 4;
+
+    if( _unicodeSize >= ((size_t)-1) / maxCodeSize )
+    {
+        return NULL;
+    }
+
+    size_t capacity = _unicodeSize * maxCodeSize + 1;
+
+    char * utf8 = (char *)(*_allocator->allocate)( capacity, _allocator->ud );
+
+    if( utf8 == NULL )
+    {
+        return NULL;
+    }
+
+    size_t utf8Size = __utf8_from_unicodez( _unicode, _unicodeSize, utf8, capacity, NULL );
+
+    if( utf8Size == UTF8_UNKNOWN )
+    {
+        if( _allocator->deallocate != NULL )
+        {
+            (*_allocator->deallocate)( utf8, capacity, _allocator->ud );
+        }
+
+        return NULL;
+    }
+
+    utf8[utf8Size] = '\0';
+
+    utf8 = (char *)__utf8_shrink( _allocator, utf8, capacity, utf8Size + 1 );
+
+    if( _utf8Size != NULL )
+    {
+        *_utf8Size = utf8Size;
+    }
+
+    return utf8;
+}
+//////////////////////////////////////////////////////////////////////////
+void utf8_arena_init( utf8_arena_t * const _arena, void * _buffer, size_t _capacity )
+{
+    _arena->buffer = (char *)_buffer;
+    _arena->capacity = _capacity;
+    _arena->size = 0;
+    _arena->last = (size_t)-1;
+}
+//////////////////////////////////////////////////////////////////////////
+void utf8_arena_reset( utf8_arena_t * const _arena )
+{
+    _arena->size = 0;
+    _arena->last = (size_t)-1;
+}
+//////////////////////////////////////////////////////////////////////////
+static void * __utf8_arena_allocate( size_t _size, void * _ud )
+{
+    utf8_arena_t * arena = (utf8_arena_t *)_ud;
+
+    // align the address, not the offset: the buffer itself may be unaligned
+    size_t padding = (size_t)(0 - (uintptr_t)(arena->buffer + arena->size)) & (UTF8_ARENA_ALIGNMENT - 1);
+    size_t offset = arena->size + padding;
+
+    if( offset > arena->capacity || _size > arena->capacity - offset )
+    {
+        return NULL;
+    }
+
+    arena->last = offset;
+    arena->size = offset + _size;
+
+    return arena->buffer + offset;
+}
+//////////////////////////////////////////////////////////////////////////
+static void * __utf8_arena_reallocate( void * _ptr, size_t _oldSize, size_t _newSize, void * _ud )
+{
+    utf8_arena_t * arena = (utf8_arena_t *)_ud;
+
+    if( arena->last != (size_t)-1 && (char *)_ptr == arena->buffer + arena->last )
+    {
+        // the most recent block can be resized in place
+        if( _newSize <= arena->capacity - arena->last )
+        {
+            arena->size = arena->last + _newSize;
+
+            return _ptr;
+        }
+
+        return NULL;
+    }
+
+    if( _newSize <= _oldSize )
+    {
+        return _ptr;
+    }
+
+    void * ptr = __utf8_arena_allocate( _newSize, _ud );
+
+    if( ptr == NULL )
+    {
+        return NULL;
+    }
+
+    memcpy( ptr, _ptr, _oldSize );
+
+    return ptr;
+}
+//////////////////////////////////////////////////////////////////////////
+static void __utf8_arena_deallocate( void * _ptr, size_t _size, void * _ud )
+{
+    (void)_size;
+
+    utf8_arena_t * arena = (utf8_arena_t *)_ud;
+
+    if( arena->last != (size_t)-1 && (char *)_ptr == arena->buffer + arena->last )
+    {
+        arena->size = arena->last;
+        arena->last = (size_t)-1;
+    }
+}
+//////////////////////////////////////////////////////////////////////////
+void utf8_arena_allocator( utf8_arena_t * const _arena, utf8_allocator_t * const _allocator )
+{
+    _allocator->allocate = &__utf8_arena_allocate;
+    _allocator->reallocate = &__utf8_arena_reallocate;
+    _allocator->deallocate = &__utf8_arena_deallocate;
+    _allocator->ud = _arena;
+}
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,185 @@
+#include "utf8_internal.h"
+
+#ifdef UTF8_SSE2
+#   include <emmintrin.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+#define UTF8_BATCH_GROUP_SIZE (8)
+//////////////////////////////////////////////////////////////////////////
+static int __utf8_batch_group_is_ascii( const utf8_span_t * _spans, size_t _count )
+{
+    // the high bits of every span are ORed into one accumulator, so the
+    // whole group costs a single test; spans of 16+ bytes fill a vector
+    // with two overlapping loads, shorter ones a 64-bit word
+    uint64_t bits = 0;
+
+#ifdef UTF8_SSE2
+    __m128i wide = _mm_setzero_si128();
+#endif
+
+    for( size_t index = 0; index != _count; ++index )
+    {
+        const char * p = _spans[index].data;
+        size_t size = _spans[index].size;
+
+#ifdef UTF8_SSE2
+        if( size >= 16 )
+        {
+            __m128i head = _mm_loadu_si128( (const __m128i *)p );
+            __m128i tail = _mm_loadu_si128( (const __m128i *)(p + size - 16) );
+
+            wide = _mm_or_si128( wide, _mm_or_si128( head, tail ) );
+
+            continue;
+        }
+#endif
+
+        bits |= __utf8_small_high_bits( p, size );
+    }
+
+#ifdef UTF8_SSE2
+    if( _mm_movemask_epi8( wide ) != 0 )
+    {
+        return 0;
+    }
+#endif
+
+    return (bits & UTF8_HIGH_BITS64) == 0;
+}
+//////////////////////////////////////////////////////////////////////////
+static size_t __utf8_batch_group( const utf8_span_t * _spans, size_t _count, int * const _ascii )
+{
+    // up to UTF8_BATCH_GROUP_SIZE consecutive short spans are tested
+    // together; a long span goes through the usual path on its own
+    size_t count = 0;
+
+    while( count != _count && count != UTF8_BATCH_GROUP_SIZE && _spans[count].size <= UTF8_SMALL_STRING_SIZE )
+    {
+        ++count;
+    }
+
+    if( count == 0 )
+    {
+        *_ascii = 0;
+
+        return 1;
+    }
+
+    *_ascii = __utf8_batch_group_is_ascii( _spans, count );
+
+    return count;
+}
+//////////////////////////////////////////////////////////////////////////
+size_t utf8_validate_batch( const utf8_span_t * _spans, size_t _count, size_t * const _offsets )
+{
+    size_t invalidCount = 0;
+
+    for( size_t index = 0; index != _count; )
+    {
+        int ascii;
+        size_t groupEnd = index + __utf8_batch_group( _spans + index, _count - index, &ascii );
+
+        // only a group with a non-ASCII byte falls back to per-span checks
+        for( ; index != groupEnd; ++index )
+        {
+            const utf8_span_t * span = _spans + index;
+
+            size_t offset = ascii == 1 ? span->size : (size_t)(__utf8_validate( span->data, span->data + span->size, NULL ) - span->data);
+
+            if( offset != span->size )
+            {
+                ++invalidCount;
+            }
+
+            if( _offsets != NULL )
+            {
+                _offsets[index] = offset;
+            }
+        }
+    }
+
+    return invalidCount;
+}
+//////////////////////////////////////////////////////////////////////////
+static size_t __utf8_batch_decode( const char * _utf8, size_t _utf8Size, int _ascii, wchar_t * const _unicode )
+{
+    const char * utf8End = _utf8 + _utf8Size;
+
+    size_t ascii = _ascii == 1 ? _utf8Size : __utf8_ascii_prefix( _utf8, utf8End );
+
+    for( size_t index = 0; index != ascii; ++index )
+    {
+        _unicode[index] = (wchar_t)(uint8_t)_utf8[index];
+    }
+
+    size_t unicodeSize = ascii;
+
+    for( const char * p = _utf8 + ascii; p != utf8End; )
+    {
+        uint32_t code;
+        const char * next = utf8_next_code( p, utf8End, &code );
+
+        if( next == NULL )
+        {
+            return UTF8_UNKNOWN;
+        }
+
+        _unicode[unicodeSize++] = (wchar_t)code;
+
+        p = next;
+    }
+
+    return unicodeSize;
+}
+//////////////////////////////////////////////////////////////////////////
+size_t utf8_to_unicodez_batch( const utf8_span_t * _spans, size_t _count, wchar_t * const _arena, size_t _arenaCapacity, utf8_batch_result_t * const _results )
+{
+    size_t arenaSize = 0;
+
+    for( size_t index = 0; index != _count; )
+    {
+        int ascii;
+        size_t groupEnd = index + __utf8_batch_group( _spans + index, _count - index, &ascii );
+
+        for( ; index != groupEnd; ++index )
+        {
+            const utf8_span_t * span = _spans + index;
+            utf8_batch_result_t * result = _results + index;
+
+            result->offset = arenaSize;
+
+            // a string never decodes to more wchar_t than it has bytes
+            if( span->size > _arenaCapacity - arenaSize )
+            {
+                size_t required = ascii == 1 ? span->size : utf8_to_unicodez_size( span->data, span->size );
+
+                if( required == UTF8_UNKNOWN )
+                {
+                    result->size = UTF8_UNKNOWN;
+
+                    continue;
+                }
+
+                if( required > _arenaCapacity - arenaSize )
+                {
+                    return UTF8_UNKNOWN;
+                }
+            }
+
+            size_t unicodeSize = __utf8_batch_decode( span->data, span->size, ascii, _arena + arenaSize );
+
+            result->size = unicodeSize;
+
+            if( unicodeSize == UTF8_UNKNOWN )
+            {
+                continue;
+            }
+
+            arenaSize += unicodeSize;
+        }
+    }
+
+    return arenaSize;
+}
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,211 @@
+#include "utf8_internal.h"
+
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////
+static const char * __utf8_cesu8_plain_run( const char * _p, const char * _end, uint32_t _flags, size_t _maxCodeSize )
+{
+    // longest prefix that is the same in both forms: valid UTF-8 without
+    // supplementary code points (and without NUL for Modified UTF-8)
+    const char * p = _p;
+
+    while( p != _end )
+    {
+        size_t ascii = __utf8_ascii_prefix( p, _end );
+
+        if( (_flags & UTF8_CESU8_MODIFIED) != 0 && ascii != 0 )
+        {
+            const char * nul = (const char *)memchr( p, '\0', ascii );
+
+            if( nul != NULL )
+            {
+                return nul;
+            }
+        }
+
+        p += ascii;
+
+        if( p == _end )
+        {
+            break;
+        }
+
+        const char * next = utf8_next_code( p, _end, NULL );
+
+        if( next == NULL || (size_t)(next - p) > _maxCodeSize )
+        {
+            break;
+        }
+
+        p = next;
+    }
+
+    return p;
+}
+//////////////////////////////////////////////////////////////////////////
+static size_t __utf8_from_cesu8( const char * _cesu8, const char * _cesu8End, uint32_t _flags, char * const _utf8, size_t _utf8Capacity )
+{
+    utf8_writer_t writer;
+    writer.out = _utf8;
+    writer.capacity = _utf8Capacity;
+    writer.size = 0;
+
+    const char * p = _cesu8;
+
+    while( p != _cesu8End )
+    {
+        const char * run = __utf8_cesu8_plain_run( p, _cesu8End, _flags, 3 );
+
+        if( __utf8_writer_write( &writer, p, (size_t)(run - p) ) == 0 )
+        {
+            return UTF8_UNKNOWN;
+        }
+
+        p = run;
+
+        if( p == _cesu8End )
+        {
+            break;
+        }
+
+        const uint8_t * u = (const uint8_t *)p;
+        size_t available = (size_t)(_cesu8End - p);
+
+        if( (_flags & UTF8_CESU8_MODIFIED) != 0 && available >= 2 && u[0] == 0xC0 && u[1] == 0x80 )
+        {
+            if( __utf8_writer_write( &writer, "", 1 ) == 0 )
+            {
+                return UTF8_UNKNOWN;
+            }
+
+            p += 2;
+
+            continue;
+        }
+
+        // a supplementary code point is a high surrogate followed by a low one
+        if( available < 6
+            || u[0] != 0xED || (u[1] & 0xF0) != 0xA0 || (u[2] & 0xC0) != 0x80
+            || u[3] != 0xED || (u[4] & 0xF0) != 0xB0 || (u[5] & 0xC0) != 0x80 )
+        {
+            return UTF8_UNKNOWN;
+        }
+
+        uint32_t hi = ((uint32_t)(u[1] & 0x0F) << 6) | (uint32_t)(u[2] & 0x3F);
+        uint32_t lo = ((uint32_t)(u[4] & 0x0F) << 6) | (uint32_t)(u[5] & 0x3F);
+
+        uint32_t code = 0x10000 + ((hi << 10) | lo);
+
+        char utf8[4];
+        size_t codeSize = utf8_from_unicode32_symbol( code, utf8 );
+
+        if( __utf8_writer_write( &writer, utf8, codeSize ) == 0 )
+        {
+            return UTF8_UNKNOWN;
+        }
+
+        p += 6;
+    }
+
+    return writer.size;
+}
+//////////////////////////////////////////////////////////////////////////
+static size_t __utf8_to_cesu8( const char * _utf8, const char * _utf8End, uint32_t _flags, char * const _cesu8, size_t _cesu8Capacity )
+{
+    utf8_writer_t writer;
+    writer.out = _cesu8;
+    writer.capacity = _cesu8Capacity;
+    writer.size = 0;
+
+    const char * p = _utf8;
+
+    while( p != _utf8End )
+    {
+        const char * run = __utf8_cesu8_plain_run( p, _utf8End, _flags, 3 );
+
+        if( __utf8_writer_write( &writer, p, (size_t)(run - p) ) == 0 )
+        {
+            return UTF8_UNKNOWN;
+        }
+
+        p = run;
+
+        if( p == _utf8End )
+        {
+            break;
+        }
+
+        if( *p == '\0' )
+        {
+            if( __utf8_writer_write( &writer, "\xC0\x80", 2 ) == 0 )
+            {
+                return UTF8_UNKNOWN;
+            }
+
+            ++p;
+
+            continue;
+        }
+
+        uint32_t code;
+        const char * next = utf8_next_code( p, _utf8End, &code );
+
+        if( next == NULL )
+        {
+            return UTF8_UNKNOWN;
+        }
+
+        code -= 0x10000;
+
+        uint32_t hi = 0xD800 | (code >> 10);
+        uint32_t lo = 0xDC00 | (code & 0x3FF);
+
+        char pair[6];
+        pair[0] = (char)0xED;
+        pair[1] = (char)(0x80 | ((hi >> 6) & 0x3F));
+        pair[2] = (char)(0x80 | (hi & 0x3F));
+        pair[3] = (char)0xED;
+        pair[4] = (char)(0x80 | ((lo >> 6) & 0x3F));
+        pair[5] = (char)(0x80 | (lo & 0x3F));
+
+        if( __utf8_writer_write( &writer, pair, 6 ) == 0 )
+        {
+            return UTF8_UNKNOWN;
+        }
+
+        p = next;
+    }
+
+    return writer.size;
+}
+//////////////////////////////////////////////////////////////////////////
+size_t utf8_from_cesu8_size( const char * _cesu8, const char * _cesu8End, uint32_t _flags )
+{
+    return __utf8_from_cesu8( _cesu8, _cesu8End, _flags, NULL, UTF8_UNKNOWN );
+}
+//////////////////////////////////////////////////////////////////////////
+size_t utf8_from_cesu8( const char * _cesu8, const char * _cesu8End, uint32_t _flags, char * const _utf8, size_t _utf8Capacity )
+{
+    if( _utf8Capacity == 0 )
+    {
+        return 0;
+    }
+
+    return __utf8_from_cesu8( _cesu8, _cesu8End, _flags, _utf8, _utf8Capacity );
+}
+//////////////////////////////////////////////////////////////////////////
+size_t utf8_to_cesu8_size( const char * _utf8, const char * _utf8End, uint32_t _flags )
+{
+    return __utf8_to_cesu8( _utf8, _utf8End, _flags, NULL, UTF8_UNKNOWN );
+}
+//////////////////////////////////////////////////////////////////////////
+size_t utf8_to_cesu8( const char * _utf8, const char * _utf8End, uint32_t _flags, char * const _cesu8, size_t _cesu8Capacity )
+{
+    if( _cesu8Capacity == 0 )
+    {
+        return 0;
+    }
+
+    return __utf8_to_cesu8( _utf8, _utf8End, _flags, _cesu8, _cesu8Capacity );
+}
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,492 @@
+#include "utf8_internal.h"
+
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////
+// Built-in single-byte code pages (generated from the Python codecs).
+// The Windows-1252 bytes 81, 8D, 8F, 90 and 9D have no assigned character
+// and map to the C1 control of the same value, as in the WHATWG encoding
+// standard, so that every byte round-trips.
+//////////////////////////////////////////////////////////////////////////
+const utf8_codepage_t utf8_codepage_windows1252 = {
+    {
+        0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+        0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+        0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+        0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178,
+        0x00A0, 0x00A1, 0x00A2, 0x00A3, 0x00A4, 0x00A5, 0x00A6, 0x00A7,
+        0x00A8, 0x00A9, 0x00AA, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x00AF,
+        0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x00B4, 0x00B5, 0x00B6, 0x00B7,
+        0x00B8, 0x00B9, 0x00BA, 0x00BB, 0x00BC, 0x00BD, 0x00BE, 0x00BF,
+        0x00C0, 0x00C1, 0x00C2, 0x00C3, 0x00C4, 0x00C5, 0x00C6, 0x00C7,
+        0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF,
+        0x00D0, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x00D7,
+        0x00D8, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x00DD, 0x00DE, 0x00DF,
+        0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x00E7,
+        0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF,
+        0x00F0, 0x00F1, 0x00F2, 0x00F3, 0x00F4, 0x00F5, 0x00F6, 0x00F7,
+        0x00F8, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x00FE, 0x00FF
+    },
+    {
+        0x03AC82E2, 0x020081C2, 0x039A80E2, 0x020092C6, 0x039E80E2, 0x03A680E2, 0x03A080E2, 0x03A180E2,
+        0x020086CB, 0x03B080E2, 0x0200A0C5, 0x03B980E2, 0x020092C5, 0x02008DC2, 0x0200BDC5, 0x02008FC2,
+        0x020090C2, 0x039880E2, 0x039980E2, 0x039C80E2, 0x039D80E2, 0x03A280E2, 0x039380E2, 0x039480E2,
+        0x02009CCB, 0x03A284E2, 0x0200A1C5, 0x03BA80E2, 0x020093C5, 0x02009DC2, 0x0200BEC5, 0x0200B8C5,
+        0x0200A0C2, 0x0200A1C2, 0x0200A2C2, 0x0200A3C2, 0x0200A4C2, 0x0200A5C2, 0x0200A6C2, 0x0200A7C2,
+        0x0200A8C2, 0x0200A9C2, 0x0200AAC2, 0x0200ABC2, 0x0200ACC2, 0x0200ADC2, 0x0200AEC2, 0x0200AFC2,
+        0x0200B0C2, 0x0200B1C2, 0x0200B2C2, 0x0200B3C2, 0x0200B4C2, 0x0200B5C2, 0x0200B6C2, 0x0200B7C2,
+        0x0200B8C2, 0x0200B9C2, 0x0200BAC2, 0x0200BBC2, 0x0200BCC2, 0x0200BDC2, 0x0200BEC2, 0x0200BFC2,
+        0x020080C3, 0x020081C3, 0x020082C3, 0x020083C3, 0x020084C3, 0x020085C3, 0x020086C3, 0x020087C3,
+        0x020088C3, 0x020089C3, 0x02008AC3, 0x02008BC3, 0x02008CC3, 0x02008DC3, 0x02008EC3, 0x02008FC3,
+        0x020090C3, 0x020091C3, 0x020092C3, 0x020093C3, 0x020094C3, 0x020095C3, 0x020096C3, 0x020097C3,
+        0x020098C3, 0x020099C3, 0x02009AC3, 0x02009BC3, 0x02009CC3, 0x02009DC3, 0x02009EC3, 0x02009FC3,
+        0x0200A0C3, 0x0200A1C3, 0x0200A2C3, 0x0200A3C3, 0x0200A4C3, 0x0200A5C3, 0x0200A6C3, 0x0200A7C3,
+        0x0200A8C3, 0x0200A9C3, 0x0200AAC3, 0x0200ABC3, 0x0200ACC3, 0x0200ADC3, 0x0200AEC3, 0x0200AFC3,
+        0x0200B0C3, 0x0200B1C3, 0x0200B2C3, 0x0200B3C3, 0x0200B4C3, 0x0200B5C3, 0x0200B6C3, 0x0200B7C3,
+        0x0200B8C3, 0x0200B9C3, 0x0200BAC3, 0x0200BBC3, 0x0200BCC3, 0x0200BDC3, 0x0200BEC3, 0x0200BFC3
+    },
+    {
+        0x00008181, 0x00008D8D, 0x00008F8F, 0x00009090, 0x00009D9D, 0x0000A0A0, 0x0000A1A1, 0x0000A2A2,
+        0x0000A3A3, 0x0000A4A4, 0x0000A5A5, 0x0000A6A6, 0x0000A7A7, 0x0000A8A8, 0x0000A9A9, 0x0000AAAA,
+        0x0000ABAB, 0x0000ACAC, 0x0000ADAD, 0x0000AEAE, 0x0000AFAF, 0x0000B0B0, 0x0000B1B1, 0x0000B2B2,
+        0x0000B3B3, 0x0000B4B4, 0x0000B5B5, 0x0000B6B6, 0x0000B7B7, 0x0000B8B8, 0x0000B9B9, 0x0000BABA,
+        0x0000BBBB, 0x0000BCBC, 0x0000BDBD, 0x0000BEBE, 0x0000BFBF, 0x0000C0C0, 0x0000C1C1, 0x0000C2C2,
+        0x0000C3C3, 0x0000C4C4, 0x0000C5C5, 0x0000C6C6, 0x0000C7C7, 0x0000C8C8, 0x0000C9C9, 0x0000CACA,
+        0x0000CBCB, 0x0000CCCC, 0x0000CDCD, 0x0000CECE, 0x0000CFCF, 0x0000D0D0, 0x0000D1D1, 0x0000D2D2,
+        0x0000D3D3, 0x0000D4D4, 0x0000D5D5, 0x0000D6D6, 0x0000D7D7, 0x0000D8D8, 0x0000D9D9, 0x0000DADA,
+        0x0000DBDB, 0x0000DCDC, 0x0000DDDD, 0x0000DEDE, 0x0000DFDF, 0x0000E0E0, 0x0000E1E1, 0x0000E2E2,
+        0x0000E3E3, 0x0000E4E4, 0x0000E5E5, 0x0000E6E6, 0x0000E7E7, 0x0000E8E8, 0x0000E9E9, 0x0000EAEA,
+        0x0000EBEB, 0x0000ECEC, 0x0000EDED, 0x0000EEEE, 0x0000EFEF, 0x0000F0F0, 0x0000F1F1, 0x0000F2F2,
+        0x0000F3F3, 0x0000F4F4, 0x0000F5F5, 0x0000F6F6, 0x0000F7F7, 0x0000F8F8, 0x0000F9F9, 0x0000FAFA,
+        0x0000FBFB, 0x0000FCFC, 0x0000FDFD, 0x0000FEFE, 0x0000FFFF, 0x0001528C, 0x0001539C, 0x0001608A,
+        0x0001619A, 0x0001789F, 0x00017D8E, 0x00017E9E, 0x00019283, 0x0002C688, 0x0002DC98, 0x00201396,
+        0x00201497, 0x00201891, 0x00201992, 0x00201A82, 0x00201C93, 0x00201D94, 0x00201E84, 0x00202086,
+        0x00202187, 0x00202295, 0x00202685, 0x00203089, 0x0020398B, 0x00203A9B, 0x0020AC80, 0x00212299
+    },
+    128
+};
+//////////////////////////////////////////////////////////////////////////
+const utf8_codepage_t utf8_codepage_latin1 = {
+    {
+        0x0080, 0x0081, 0x0082, 0x0083, 0x0084, 0x0085, 0x0086, 0x0087,
+        0x0088, 0x0089, 0x008A, 0x008B, 0x008C, 0x008D, 0x008E, 0x008F,
+        0x0090, 0x0091, 0x0092, 0x0093, 0x0094, 0x0095, 0x0096, 0x0097,
+        0x0098, 0x0099, 0x009A, 0x009B, 0x009C, 0x009D, 0x009E, 0x009F,
+        0x00A0, 0x00A1, 0x00A2, 0x00A3, 0x00A4, 0x00A5, 0x00A6, 0x00A7,
+        0x00A8, 0x00A9, 0x00AA, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x00AF,
+        0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x00B4, 0x00B5, 0x00B6, 0x00B7,
+        0x00B8, 0x00B9, 0x00BA, 0x00BB, 0x00BC, 0x00BD, 0x00BE, 0x00BF,
+        0x00C0, 0x00C1, 0x00C2, 0x00C3, 0x00C4, 0x00C5, 0x00C6, 0x00C7,
+        0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF,
+        0x00D0, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x00D7,
+        0x00D8, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x00DD, 0x00DE, 0x00DF,
+        0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x00E7,
+        0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF,
+        0x00F0, 0x00F1, 0x00F2, 0x00F3, 0x00F4, 0x00F5, 0x00F6, 0x00F7,
+        0x00F8, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x00FE, 0x00FF
+    },
+    {
+        0x020080C2, 0x020081C2, 0x020082C2, 0x020083C2, 0x020084C2, 0x020085C2, 0x020086C2, 0x020087C2,
+        0x020088C2, 0x020089C2, 0x02008AC2, 0x02008BC2, 0x02008CC2, 0x02008DC2, 0x02008EC2, 0x02008FC2,
+        0x020090C2, 0x020091C2, 0x020092C2, 0x020093C2, 0x020094C2, 0x020095C2, 0x020096C2, 0x020097C2,
+        0x020098C2, 0x020099C2, 0x02009AC2, 0x02009BC2, 0x02009CC2, 0x02009DC2, 0x02009EC2, 0x02009FC2,
+        0x0200A0C2, 0x0200A1C2, 0x0200A2C2, 0x0200A3C2, 0x0200A4C2, 0x0200A5C2, 0x0200A6C2, 0x0200A7C2,
+        0x0200A8C2, 0x0200A9C2, 0x0200AAC2, 0x0200ABC2, 0x0200ACC2, 0x0200ADC2, 0x0200AEC2, 0x0200AFC2,
+        0x0200B0C2, 0x0200B1C2, 0x0200B2C2, 0x0200B3C2, 0x0200B4C2, 0x0200B5C2, 0x0200B6C2, 0x0200B7C2,
+        0x0200B8C2, 0x0200B9C2, 0x0200BAC2, 0x0200BBC2, 0x0200BCC2, 0x0200BDC2, 0x0200BEC2, 0x0200BFC2,
+        0x020080C3, 0x020081C3, 0x020082C3, 0x020083C3, 0x020084C3, 0x020085C3, 0x020086C3, 0x020087C3,
+        0x020088C3, 0x020089C3, 0x02008AC3, 0x02008BC3, 0x02008CC3, 0x02008DC3, 0x02008EC3, 0x02008FC3,
+        0x020090C3, 0x020091C3, 0x020092C3, 0x020093C3, 0x020094C3, 0x020095C3, 0x020096C3, 0x020097C3,
+        0x020098C3, 0x020099C3, 0x02009AC3, 0x02009BC3, 0x02009CC3, 0x02009DC3, 0x02009EC3, 0x02009FC3,
+        0x0200A0C3, 0x0200A1C3, 0x0200A2C3, 0x0200A3C3, 0x0200A4C3, 0x0200A5C3, 0x0200A6C3, 0x0200A7C3,
+        0x0200A8C3, 0x0200A9C3, 0x0200AAC3, 0x0200ABC3, 0x0200ACC3, 0x0200ADC3, 0x0200AEC3, 0x0200AFC3,
+        0x0200B0C3, 0x0200B1C3, 0x0200B2C3, 0x0200B3C3, 0x0200B4C3, 0x0200B5C3, 0x0200B6C3, 0x0200B7C3,
+        0x0200B8C3, 0x0200B9C3, 0x0200BAC3, 0x0200BBC3, 0x0200BCC3, 0x0200BDC3, 0x0200BEC3, 0x0200BFC3
+    },
+    {
+        0x00008080, 0x00008181, 0x00008282, 0x00008383, 0x00008484, 0x00008585, 0x00008686, 0x00008787,
+        0x00008888, 0x00008989, 0x00008A8A, 0x00008B8B, 0x00008C8C, 0x00008D8D, 0x00008E8E, 0x00008F8F,
+        0x00009090, 0x00009191, 0x00009292, 0x00009393, 0x00009494, 0x00009595, 0x00009696, 0x00009797,
+        0x00009898, 0x00009999, 0x00009A9A, 0x00009B9B, 0x00009C9C, 0x00009D9D, 0x00009E9E, 0x00009F9F,
+        0x0000A0A0, 0x0000A1A1, 0x0000A2A2, 0x0000A3A3, 0x0000A4A4, 0x0000A5A5, 0x0000A6A6, 0x0000A7A7,
+        0x0000A8A8, 0x0000A9A9, 0x0000AAAA, 0x0000ABAB, 0x0000ACAC, 0x0000ADAD, 0x0000AEAE, 0x0000AFAF,
+        0x0000B0B0, 0x0000B1B1, 0x0000B2B2, 0x0000B3B3, 0x0000B4B4, 0x0000B5B5, 0x0000B6B6, 0x0000B7B7,
+        0x0000B8B8, 0x0000B9B9, 0x0000BABA, 0x0000BBBB, 0x0000BCBC, 0x0000BDBD, 0x0000BEBE, 0x0000BFBF,
+        0x0000C0C0, 0x0000C1C1, 0x0000C2C2, 0x0000C3C3, 0x0000C4C4, 0x0000C5C5, 0x0000C6C6, 0x0000C7C7,
+        0x0000C8C8, 0x0000C9C9, 0x0000CACA, 0x0000CBCB, 0x0000CCCC, 0x0000CDCD, 0x0000CECE, 0x0000CFCF,
+        0x0000D0D0, 0x0000D1D1, 0x0000D2D2, 0x0000D3D3, 0x0000D4D4, 0x0000D5D5, 0x0000D6D6, 0x0000D7D7,
+        0x0000D8D8, 0x0000D9D9, 0x0000DADA, 0x0000DBDB, 0x0000DCDC, 0x0000DDDD, 0x0000DEDE, 0x0000DFDF,
+        0x0000E0E0, 0x0000E1E1, 0x0000E2E2, 0x0000E3E3, 0x0000E4E4, 0x0000E5E5, 0x0000E6E6, 0x0000E7E7,
+        0x0000E8E8, 0x0000E9E9, 0x0000EAEA, 0x0000EBEB, 0x0000ECEC, 0x0000EDED, 0x0000EEEE, 0x0000EFEF,
+        0x0000F0F0, 0x0000F1F1, 0x0000F2F2, 0x0000F3F3, 0x0000F4F4, 0x0000F5F5, 0x0000F6F6, 0x0000F7F7,
+        0x0000F8F8, 0x0000F9F9, 0x0000FAFA, 0x0000FBFB, 0x0000FCFC, 0x0000FDFD, 0x0000FEFE, 0x0000FFFF
+    },
+    128
+};
+//////////////////////////////////////////////////////////////////////////
+const utf8_codepage_t utf8_codepage_koi8r = {
+    {
+        0x2500, 0x2502, 0x250C, 0x2510, 0x2514, 0x2518, 0x251C, 0x2524,
+        0x252C, 0x2534, 0x253C, 0x2580, 0x2584, 0x2588, 0x258C, 0x2590,
+        0x2591, 0x2592, 0x2593, 0x2320, 0x25A0, 0x2219, 0x221A, 0x2248,
+        0x2264, 0x2265, 0x00A0, 0x2321, 0x00B0, 0x00B2, 0x00B7, 0x00F7,
+        0x2550, 0x2551, 0x2552, 0x0451, 0x2553, 0x2554, 0x2555, 0x2556,
+        0x2557, 0x2558, 0x2559, 0x255A, 0x255B, 0x255C, 0x255D, 0x255E,
+        0x255F, 0x2560, 0x2561, 0x0401, 0x2562, 0x2563, 0x2564, 0x2565,
+        0x2566, 0x2567, 0x2568, 0x2569, 0x256A, 0x256B, 0x256C, 0x00A9,
+        0x044E, 0x0430, 0x0431, 0x0446, 0x0434, 0x0435, 0x0444, 0x0433,
+        0x0445, 0x0438, 0x0439, 0x043A, 0x043B, 0x043C, 0x043D, 0x043E,
+        0x043F, 0x044F, 0x0440, 0x0441, 0x0442, 0x0443, 0x0436, 0x0432,
+        0x044C, 0x044B, 0x0437, 0x0448, 0x044D, 0x0449, 0x0447, 0x044A,
+        0x042E, 0x0410, 0x0411, 0x0426, 0x0414, 0x0415, 0x0424, 0x0413,
+        0x0425, 0x0418, 0x0419, 0x041A, 0x041B, 0x041C, 0x041D, 0x041E,
+        0x041F, 0x042F, 0x0420, 0x0421, 0x0422, 0x0423, 0x0416, 0x0412,
+        0x042C, 0x042B, 0x0417, 0x0428, 0x042D, 0x0429, 0x0427, 0x042A
+    },
+    {
+        0x038094E2, 0x038294E2, 0x038C94E2, 0x039094E2, 0x039494E2, 0x039894E2, 0x039C94E2, 0x03A494E2,
+        0x03AC94E2, 0x03B494E2, 0x03BC94E2, 0x038096E2, 0x038496E2, 0x038896E2, 0x038C96E2, 0x039096E2,
+        0x039196E2, 0x039296E2, 0x039396E2, 0x03A08CE2, 0x03A096E2, 0x039988E2, 0x039A88E2, 0x038889E2,
+        0x03A489E2, 0x03A589E2, 0x0200A0C2, 0x03A18CE2, 0x0200B0C2, 0x0200B2C2, 0x0200B7C2, 0x0200B7C3,
+        0x039095E2, 0x039195E2, 0x039295E2, 0x020091D1, 0x039395E2, 0x039495E2, 0x039595E2, 0x039695E2,
+        0x039795E2, 0x039895E2, 0x039995E2, 0x039A95E2, 0x039B95E2, 0x039C95E2, 0x039D95E2, 0x039E95E2,
+        0x039F95E2, 0x03A095E2, 0x03A195E2, 0x020081D0, 0x03A295E2, 0x03A395E2, 0x03A495E2, 0x03A595E2,
+        0x03A695E2, 0x03A795E2, 0x03A895E2, 0x03A995E2, 0x03AA95E2, 0x03AB95E2, 0x03AC95E2, 0x0200A9C2,
+        0x02008ED1, 0x0200B0D0, 0x0200B1D0, 0x020086D1, 0x0200B4D0, 0x0200B5D0, 0x020084D1, 0x0200B3D0,
+        0x020085D1, 0x0200B8D0, 0x0200B9D0, 0x0200BAD0, 0x0200BBD0, 0x0200BCD0, 0x0200BDD0, 0x0200BED0,
+        0x0200BFD0, 0x02008FD1, 0x020080D1, 0x020081D1, 0x020082D1, 0x020083D1, 0x0200B6D0, 0x0200B2D0,
+        0x02008CD1, 0x02008BD1, 0x0200B7D0, 0x020088D1, 0x02008DD1, 0x020089D1, 0x020087D1, 0x02008AD1,
+        0x0200AED0, 0x020090D0, 0x020091D0, 0x0200A6D0, 0x020094D0, 0x020095D0, 0x0200A4D0, 0x020093D0,
+        0x0200A5D0, 0x020098D0, 0x020099D0, 0x02009AD0, 0x02009BD0, 0x02009CD0, 0x02009DD0, 0x02009ED0,
+        0x02009FD0, 0x0200AFD0, 0x0200A0D0, 0x0200A1D0, 0x0200A2D0, 0x0200A3D0, 0x020096D0, 0x020092D0,
+        0x0200ACD0, 0x0200ABD0, 0x020097D0, 0x0200A8D0, 0x0200ADD0, 0x0200A9D0, 0x0200A7D0, 0x0200AAD0
+    },
+    {
+        0x0000A09A, 0x0000A9BF, 0x0000B09C, 0x0000B29D, 0x0000B79E, 0x0000F79F, 0x000401B3, 0x000410E1,
+        0x000411E2, 0x000412F7, 0x000413E7, 0x000414E4, 0x000415E5, 0x000416F6, 0x000417FA, 0x000418E9,
+        0x000419EA, 0x00041AEB, 0x00041BEC, 0x00041CED, 0x00041DEE, 0x00041EEF, 0x00041FF0, 0x000420F2,
+        0x000421F3, 0x000422F4, 0x000423F5, 0x000424E6, 0x000425E8, 0x000426E3, 0x000427FE, 0x000428FB,
+        0x000429FD, 0x00042AFF, 0x00042BF9, 0x00042CF8, 0x00042DFC, 0x00042EE0, 0x00042FF1, 0x000430C1,
+        0x000431C2, 0x000432D7, 0x000433C7, 0x000434C4, 0x000435C5, 0x000436D6, 0x000437DA, 0x000438C9,
+        0x000439CA, 0x00043ACB, 0x00043BCC, 0x00043CCD, 0x00043DCE, 0x00043ECF, 0x00043FD0, 0x000440D2,
+        0x000441D3, 0x000442D4, 0x000443D5, 0x000444C6, 0x000445C8, 0x000446C3, 0x000447DE, 0x000448DB,
+        0x000449DD, 0x00044ADF, 0x00044BD9, 0x00044CD8, 0x00044DDC, 0x00044EC0, 0x00044FD1, 0x000451A3,
+        0x00221995, 0x00221A96, 0x00224897, 0x00226498, 0x00226599, 0x00232093, 0x0023219B, 0x00250080,
+        0x00250281, 0x00250C82, 0x00251083, 0x00251484, 0x00251885, 0x00251C86, 0x00252487, 0x00252C88,
+        0x00253489, 0x00253C8A, 0x002550A0, 0x002551A1, 0x002552A2, 0x002553A4, 0x002554A5, 0x002555A6,
+        0x002556A7, 0x002557A8, 0x002558A9, 0x002559AA, 0x00255AAB, 0x00255BAC, 0x00255CAD, 0x00255DAE,
+        0x00255EAF, 0x00255FB0, 0x002560B1, 0x002561B2, 0x002562B4, 0x002563B5, 0x002564B6, 0x002565B7,
+        0x002566B8, 0x002567B9, 0x002568BA, 0x002569BB, 0x00256ABC, 0x00256BBD, 0x00256CBE, 0x0025808B,
+        0x0025848C, 0x0025888D, 0x00258C8E, 0x0025908F, 0x00259190, 0x00259291, 0x00259392, 0x0025A094
+    },
+    128
+};
+//////////////////////////////////////////////////////////////////////////
+const utf8_codepage_t utf8_codepage_iso8859_5 = {
+    {
+        0x0080, 0x0081, 0x0082, 0x0083, 0x0084, 0x0085, 0x0086, 0x0087,
+        0x0088, 0x0089, 0x008A, 0x008B, 0x008C, 0x008D, 0x008E, 0x008F,
+        0x0090, 0x0091, 0x0092, 0x0093, 0x0094, 0x0095, 0x0096, 0x0097,
+        0x0098, 0x0099, 0x009A, 0x009B, 0x009C, 0x009D, 0x009E, 0x009F,
+        0x00A0, 0x0401, 0x0402, 0x0403, 0x0404, 0x0405, 0x0406, 0x0407,
+        0x0408, 0x0409, 0x040A, 0x040B, 0x040C, 0x00AD, 0x040E, 0x040F,
+        0x0410, 0x0411, 0x0412, 0x0413, 0x0414, 0x0415, 0x0416, 0x0417,
+        0x0418, 0x0419, 0x041A, 0x041B, 0x041C, 0x041D, 0x041E, 0x041F,
+        0x0420, 0x0421, 0x0422, 0x0423, 0x0424, 0x0425, 0x0426, 0x0427,
+        0x0428, 0x0429, 0x042A, 0x042B, 0x042C, 0x042D, 0x042E, 0x042F,
+        0x0430, 0x0431, 0x0432, 0x0433, 0x0434, 0x0435, 0x0436, 0x0437,
+        0x0438, 0x0439, 0x043A, 0x043B, 0x043C, 0x043D, 0x043E, 0x043F,
+        0x0440, 0x0441, 0x0442, 0x0443, 0x0444, 0x0445, 0x0446, 0x0447,
+        0x0448, 0x0449, 0x044A, 0x044B, 0x044C, 0x044D, 0x044E, 0x044F,
+        0x2116, 0x0451, 0x0452, 0x0453, 0x0454, 0x0455, 0x0456, 0x0457,
+        0x0458, 0x0459, 0x045A, 0x045B, 0x045C, 0x00A7, 0x045E, 0x045F
+    },
+    {
+        0x020080C2, 0x020081C2, 0x020082C2, 0x020083C2, 0x020084C2, 0x020085C2, 0x020086C2, 0x020087C2,
+        0x020088C2, 0x020089C2, 0x02008AC2, 0x02008BC2, 0x02008CC2, 0x02008DC2, 0x02008EC2, 0x02008FC2,
+        0x020090C2, 0x020091C2, 0x020092C2, 0x020093C2, 0x020094C2, 0x020095C2, 0x020096C2, 0x020097C2,
+        0x020098C2, 0x020099C2, 0x02009AC2, 0x02009BC2, 0x02009CC2, 0x02009DC2, 0x02009EC2, 0x02009FC2,
+        0x0200A0C2, 0x020081D0, 0x020082D0, 0x020083D0, 0x020084D0, 0x020085D0, 0x020086D0, 0x020087D0,
+        0x020088D0, 0x020089D0, 0x02008AD0, 0x02008BD0, 0x02008CD0, 0x0200ADC2, 0x02008ED0, 0x02008FD0,
+        0x020090D0, 0x020091D0, 0x020092D0, 0x020093D0, 0x020094D0, 0x020095D0, 0x020096D0, 0x020097D0,
+        0x020098D0, 0x020099D0, 0x02009AD0, 0x02009BD0, 0x02009CD0, 0x02009DD0, 0x02009ED0, 0x02009FD0,
+        0x0200A0D0, 0x0200A1D0, 0x0200A2D0, 0x0200A3D0, 0x0200A4D0, 0x0200A5D0, 0x0200A6D0, 0x0200A7D0,
+        0x0200A8D0, 0x0200A9D0, 0x0200AAD0, 0x0200ABD0, 0x0200ACD0, 0x0200ADD0, 0x0200AED0, 0x0200AFD0,
+        0x0200B0D0, 0x0200B1D0, 0x0200B2D0, 0x0200B3D0, 0x0200B4D0, 0x0200B5D0, 0x0200B6D0, 0x0200B7D0,
+        0x0200B8D0, 0x0200B9D0, 0x0200BAD0, 0x0200BBD0, 0x0200BCD0, 0x0200BDD0, 0x0200BED0, 0x0200BFD0,
+        0x020080D1, 0x020081D1, 0x020082D1, 0x020083D1, 0x020084D1, 0x020085D1, 0x020086D1, 0x020087D1,
+        0x020088D1, 0x020089D1, 0x02008AD1, 0x02008BD1, 0x02008CD1, 0x02008DD1, 0x02008ED1, 0x02008FD1,
+        0x039684E2, 0x020091D1, 0x020092D1, 0x020093D1, 0x020094D1, 0x020095D1, 0x020096D1, 0x020097D1,
+        0x020098D1, 0x020099D1, 0x02009AD1, 0x02009BD1, 0x02009CD1, 0x0200A7C2, 0x02009ED1, 0x02009FD1
+    },
+    {
+        0x00008080, 0x00008181, 0x00008282, 0x00008383, 0x00008484, 0x00008585, 0x00008686, 0x00008787,
+        0x00008888, 0x00008989, 0x00008A8A, 0x00008B8B, 0x00008C8C, 0x00008D8D, 0x00008E8E, 0x00008F8F,
+        0x00009090, 0x00009191, 0x00009292, 0x00009393, 0x00009494, 0x00009595, 0x00009696, 0x00009797,
+        0x00009898, 0x00009999, 0x00009A9A, 0x00009B9B, 0x00009C9C, 0x00009D9D, 0x00009E9E, 0x00009F9F,
+        0x0000A0A0, 0x0000A7FD, 0x0000ADAD, 0x000401A1, 0x000402A2, 0x000403A3, 0x000404A4, 0x000405A5,
+        0x000406A6, 0x000407A7, 0x000408A8, 0x000409A9, 0x00040AAA, 0x00040BAB, 0x00040CAC, 0x00040EAE,
+        0x00040FAF, 0x000410B0, 0x000411B1, 0x000412B2, 0x000413B3, 0x000414B4, 0x000415B5, 0x000416B6,
+        0x000417B7, 0x000418B8, 0x000419B9, 0x00041ABA, 0x00041BBB, 0x00041CBC, 0x00041DBD, 0x00041EBE,
+        0x00041FBF, 0x000420C0, 0x000421C1, 0x000422C2, 0x000423C3, 0x000424C4, 0x000425C5, 0x000426C6,
+        0x000427C7, 0x000428C8, 0x000429C9, 0x00042ACA, 0x00042BCB, 0x00042CCC, 0x00042DCD, 0x00042ECE,
+        0x00042FCF, 0x000430D0, 0x000431D1, 0x000432D2, 0x000433D3, 0x000434D4, 0x000435D5, 0x000436D6,
+        0x000437D7, 0x000438D8, 0x000439D9, 0x00043ADA, 0x00043BDB, 0x00043CDC, 0x00043DDD, 0x00043EDE,
+        0x00043FDF, 0x000440E0, 0x000441E1, 0x000442E2, 0x000443E3, 0x000444E4, 0x000445E5, 0x000446E6,
+        0x000447E7, 0x000448E8, 0x000449E9, 0x00044AEA, 0x00044BEB, 0x00044CEC, 0x00044DED, 0x00044EEE,
+        0x00044FEF, 0x000451F1, 0x000452F2, 0x000453F3, 0x000454F4, 0x000455F5, 0x000456F6, 0x000457F7,
+        0x000458F8, 0x000459F9, 0x00045AFA, 0x00045BFB, 0x00045CFC, 0x00045EFE, 0x00045FFF, 0x002116F0
+    },
+    128
+};
+//////////////////////////////////////////////////////////////////////////
+size_t utf8_codepage_init( utf8_codepage_t * const _codepage, const uint16_t * _high )
+{
+    size_t count = 0;
+
+    for( size_t index = 0; index != 128; ++index )
+    {
+        uint16_t code = _high[index];
+
+        if( code >= UTF8_SURROGATE_LO && code <= UTF8_SURROGATE_HI )
+        {
+            return UTF8_UNKNOWN;
+        }
+
+        _codepage->high[index] = code;
+
+        if( code == 0 )
+        {
+            _codepage->encoded[index] = 0;
+
+            continue;
+        }
+
+        char utf8[4];
+        size_t codeSize = utf8_from_unicode32_symbol( code, utf8 );
+
+        uint32_t encoded = (uint32_t)codeSize << 24;
+
+        for( size_t byte = 0; byte != codeSize; ++byte )
+        {
+            encoded |= (uint32_t)(uint8_t)utf8[byte] << (8 * byte);
+        }
+
+        _codepage->encoded[index] = encoded;
+
+        // insertion sort; with equal code points the lowest byte wins
+        uint32_t entry = ((uint32_t)code << 8) | (uint32_t)(0x80 + index);
+
+        size_t at = count++;
+
+        while( at != 0 && _codepage->reverse[at - 1] > entry )
+        {
+            _codepage->reverse[at] = _codepage->reverse[at - 1];
+            --at;
+        }
+
+        _codepage->reverse[at] = entry;
+    }
+
+    for( size_t index = count; index != 128; ++index )
+    {
+        _codepage->reverse[index] = 0;
+    }
+
+    _codepage->reverse_count = count;
+
+    return count;
+}
+//////////////////////////////////////////////////////////////////////////
+static size_t __utf8_codepage_ascii_copy( const char * _data, const char * _dataEnd, char * const _out, size_t _outCapacity )
+{
+    size_t ascii = __utf8_ascii_prefix( _data, _dataEnd );
+
+    if( ascii > _outCapacity )
+    {
+        ascii = _outCapacity;
+    }
+
+    if( _out != NULL )
+    {
+        memcpy( _out, _data, ascii );
+    }
+
+    return ascii;
+}
+//////////////////////////////////////////////////////////////////////////
+size_t utf8_from_codepage_size( const char * _data, size_t _dataSize, const utf8_codepage_t * _codepage )
+{
+    if( _dataSize == UTF8_UNKNOWN )
+    {
+        _dataSize = strlen( _data );
+    }
+
+    const char * p = _data;
+    const char * p_end = _data + _dataSize;
+
+    size_t utf8Size = 0;
+
+    while( p != p_end )
+    {
+        size_t ascii = __utf8_ascii_prefix( p, p_end );
+
+        utf8Size += ascii;
+        p += ascii;
+
+        if( p == p_end )
+        {
+            break;
+        }
+
+        uint32_t encoded = _codepage->encoded[(uint8_t)*p - 0x80];
+
+        if( encoded == 0 )
+        {
+            return UTF8_UNKNOWN;
+        }
+
+        utf8Size += encoded >> 24;
+        ++p;
+    }
+
+    return utf8Size;
+}
+//////////////////////////////////////////////////////////////////////////
+size_t utf8_from_codepage( const char * _data, size_t _dataSize, const utf8_codepage_t * _codepage, char * const _utf8, size_t _utf8Capacity )
+{
+    if( _utf8Capacity == 0 )
+    {
+        return 0;
+    }
+
+    if( _dataSize == UTF8_UNKNOWN )
+    {
+        _dataSize = strlen( _data );
+    }
+
+    const char * p = _data;
+    const char * p_end = _data + _dataSize;
+
+    size_t utf8Size = 0;
+
+    while( p != p_end )
+    {
+        size_t ascii = __utf8_codepage_ascii_copy( p, p_end, _utf8 + utf8Size, _utf8Capacity - utf8Size );
+
+        utf8Size += ascii;
+        p += ascii;
+
+        if( p == p_end )
+        {
+            break;
+        }
+
+        if( (uint8_t)*p < 0x80 )
+        {
+            // ASCII that did not fit
+            return UTF8_UNKNOWN;
+        }
+
+        // the table holds each high byte already encoded, so no per-code branching
+        uint32_t encoded = _codepage->encoded[(uint8_t)*p - 0x80];
+
+        size_t codeSize = encoded >> 24;
+
+        if( codeSize == 0 || codeSize > _utf8Capacity - utf8Size )
+        {
+            return UTF8_UNKNOWN;
+        }
+
+        for( size_t byte = 0; byte != codeSize; ++byte )
+        {
+            _utf8[utf8Size + byte] = (char)(encoded >> (8 * byte));
+        }
+
+        utf8Size += codeSize;
+        ++p;
+    }
+
+    return utf8Size;
+}
+//////////////////////////////////////////////////////////////////////////
+static int __utf8_codepage_lookup( const utf8_codepage_t * _codepage, uint32_t _code, char * const _byte )
+{
+    size_t lo = 0;
+    size_t hi = _codepage->reverse_count;
+
+    while( lo != hi )
+    {
+        size_t mid = (lo + hi) / 2;
+
+        uint32_t code = _codepage->reverse[mid] >> 8;
+
+        if( code < _code )
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    if( lo == _codepage->reverse_count || (_codepage->reverse[lo] >> 8) != _code )
+    {
+        return 0;
+    }
+
+    *_byte = (char)(_codepage->reverse[lo] & 0xFF);
+
+    return 1;
+}
+//////////////////////////////////////////////////////////////////////////
+size_t utf8_to_codepage( const char * _utf8, size_t _utf8Size, const utf8_codepage_t * _codepage, char * const _data, size_t _dataCapacity )
+{
+    if( _dataCapacity == 0 )
+    {
+        return 0;
+    }
+
+    if( _utf8Size == UTF8_UNKNOWN )
+    {
+        _utf8Size = strlen( _utf8 );
+    }
+
+    const char * p = _utf8;
+    const char * p_end = _utf8 + _utf8Size;
+
+    size_t dataSize = 0;
+
+    while( p != p_end )
+    {
+        size_t ascii = __utf8_codepage_ascii_copy( p, p_end, _data + dataSize, _dataCapacity - dataSize );
+
+        dataSize += ascii;
+        p += ascii;
+
+        if( p == p_end )
+        {
+            break;
+        }
+
+        if( dataSize == _dataCapacity )
+        {
+            return UTF8_UNKNOWN;
+        }
+
+        uint32_t code;
+        const char * next = utf8_next_code( p, p_end, &code );
+
+        if( next == NULL || __utf8_codepage_lookup( _codepage, code, _data + dataSize ) == 0 )
+        {
+            return UTF8_UNKNOWN;
+        }
+
+        ++dataSize;
+        p = next;
+    }
+
+    return dataSize;
+}
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,282 @@
+#include "utf8_internal.h"
+
+#include <string.h>
+
+#ifdef UTF8_SSE2
+#   include <emmintrin.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+typedef struct utf8_detect_counters_t
+{
+    size_t nulEven;
+    size_t nulOdd;
+    size_t high;
+    size_t c1;
+    size_t undefined1252;
+    size_t invalid;
+} utf8_detect_counters_t;
+//////////////////////////////////////////////////////////////////////////
+static size_t __utf8_detect_bom( const uint8_t * _data, size_t _size, utf8_encoding_e * const _encoding )
+{
+    if( _size >= 3 && _data[0] == 0xEF && _data[1] == 0xBB && _data[2] == 0xBF )
+    {
+        *_encoding = UTF8_ENCODING_UTF8;
+
+        return 3;
+    }
+
+    if( _size >= 2 && _data[0] == 0xFF && _data[1] == 0xFE )
+    {
+        *_encoding = UTF8_ENCODING_UTF16LE;
+
+        return 2;
+    }
+
+    if( _size >= 2 && _data[0] == 0xFE && _data[1] == 0xFF )
+    {
+        *_encoding = UTF8_ENCODING_UTF16BE;
+
+        return 2;
+    }
+
+    *_encoding = UTF8_ENCODING_UNKNOWN;
+
+    return 0;
+}
+//////////////////////////////////////////////////////////////////////////
+static int __utf8_detect_truncated_tail( const uint8_t * _data, size_t _size )
+{
+    // a sample may cut the last sequence short; that is not an error
+    uint8_t lead = _data[0];
+
+    size_t codeSize = (lead >= 0xC2 && lead <= 0xDF) ? 2 : (lead >= 0xE0 && lead <= 0xEF) ? 3 : (lead >= 0xF0 && lead <= 0xF4) ? 4 : 0;
+
+    if( codeSize <= _size )
+    {
+        return 0;
+    }
+
+    for( size_t index = 1; index != _size; ++index )
+    {
+        if( (_data[index] & 0xC0) != 0x80 )
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+//////////////////////////////////////////////////////////////////////////
+static void __utf8_detect_high_byte( utf8_detect_counters_t * const _counters, uint8_t _code )
+{
+    _counters->high += 1;
+
+    if( _code < 0xA0 )
+    {
+        _counters->c1 += 1;
+
+        if( _code == 0x81 || _code == 0x8D || _code == 0x8F || _code == 0x90 || _code == 0x9D )
+        {
+            _counters->undefined1252 += 1;
+        }
+    }
+}
+//////////////////////////////////////////////////////////////////////////
+static size_t __utf8_detect_scan( const uint8_t * _data, size_t _size, utf8_detect_counters_t * const _counters )
+{
+    size_t invalidOffset = _size;
+
+    size_t i = 0;
+
+    while( i != _size )
+    {
+#ifdef UTF8_SSE2
+        if( _size - i >= 16 )
+        {
+            __m128i v = _mm_loadu_si128( (const __m128i *)(_data + i) );
+
+            if( _mm_movemask_epi8( v ) == 0 )
+            {
+                // ASCII block: only NUL parity matters
+                uint32_t nul = (uint32_t)_mm_movemask_epi8( _mm_cmpeq_epi8( v, _mm_setzero_si128() ) );
+
+                if( nul != 0 )
+                {
+                    uint32_t even = __utf8_popcount32( nul & 0x5555 );
+                    uint32_t odd = __utf8_popcount32( nul & 0xAAAA );
+
+                    _counters->nulEven += (i & 1) == 0 ? even : odd;
+                    _counters->nulOdd += (i & 1) == 0 ? odd : even;
+                }
+
+                i += 16;
+
+                continue;
+            }
+        }
+#endif
+
+        uint8_t c = _data[i];
+
+        if( c < 0x80 )
+        {
+            if( c == 0 )
+            {
+                if( (i & 1) == 0 )
+                {
+                    _counters->nulEven += 1;
+                }
+                else
+                {
+                    _counters->nulOdd += 1;
+                }
+            }
+
+            ++i;
+
+            continue;
+        }
+
+        const char * code = (const char *)(_data + i);
+        const char * next = utf8_next_code( code, (const char *)(_data + _size), NULL );
+
+        size_t codeSize = next != NULL ? (size_t)(next - code) : 1;
+
+        if( next == NULL )
+        {
+            if( _size - i < 4 && __utf8_detect_truncated_tail( _data + i, _size - i ) == 1 )
+            {
+                codeSize = _size - i;
+            }
+            else
+            {
+                _counters->invalid += 1;
+
+                if( invalidOffset == _size )
+                {
+                    invalidOffset = i;
+                }
+            }
+        }
+
+        for( size_t index = 0; index != codeSize; ++index )
+        {
+            __utf8_detect_high_byte( _counters, _data[i + index] );
+        }
+
+        i += codeSize;
+    }
+
+    return invalidOffset;
+}
+//////////////////////////////////////////////////////////////////////////
+static uint32_t __utf8_detect_clamp( int _score )
+{
+    return _score < 0 ? 0 : _score > 100 ? 100 : (uint32_t)_score;
+}
+//////////////////////////////////////////////////////////////////////////
+utf8_encoding_e utf8_detect( const char * _data, size_t _size, utf8_detect_t * const _result )
+{
+    utf8_detect_t result;
+    memset( &result, 0, sizeof( result ) );
+
+    const uint8_t * data = (const uint8_t *)_data;
+
+    utf8_encoding_e bomEncoding;
+    result.bom_size = __utf8_detect_bom( data, _size, &bomEncoding );
+
+    utf8_detect_counters_t counters;
+    memset( &counters, 0, sizeof( counters ) );
+
+    size_t sampleSize = _size - result.bom_size;
+
+    result.utf8_invalid_offset = result.bom_size + __utf8_detect_scan( data + result.bom_size, sampleSize, &counters );
+
+    // parity is counted from the end of the BOM; report it from the buffer start
+    result.nul_even = (result.bom_size & 1) == 0 ? counters.nulEven : counters.nulOdd;
+    result.nul_odd = (result.bom_size & 1) == 0 ? counters.nulOdd : counters.nulEven;
+    result.high_bytes = counters.high;
+    result.c1_bytes = counters.c1;
+
+    size_t nul = counters.nulEven + counters.nulOdd;
+    size_t pairs = sampleSize / 2 + 1;
+
+    int utf8Valid = counters.invalid == 0;
+    int nulHeavy = nul * 8 >= sampleSize && nul != 0;
+    int nulPenalty = nulHeavy ? 60 : nul != 0 ? 20 : 0;
+
+    int scores[__UTF8_ENCODING_COUNT__];
+    scores[UTF8_ENCODING_UNKNOWN] = 0;
+
+    // UTF-16: ASCII text leaves a NUL in every other byte
+    scores[UTF8_ENCODING_UTF16LE] = counters.nulOdd * 4 >= pairs && counters.nulEven * 4 < counters.nulOdd ? 60 + (int)(40 * counters.nulOdd / pairs) : 0;
+    scores[UTF8_ENCODING_UTF16BE] = counters.nulEven * 4 >= pairs && counters.nulOdd * 4 < counters.nulEven ? 60 + (int)(40 * counters.nulEven / pairs) : 0;
+
+    scores[UTF8_ENCODING_ASCII] = counters.high == 0 ? 100 - nulPenalty : 0;
+    scores[UTF8_ENCODING_UTF8] = utf8Valid ? (counters.high != 0 ? 95 : 90) - nulPenalty : 0;
+
+    if( counters.high == 0 )
+    {
+        scores[UTF8_ENCODING_WINDOWS1252] = 60 - nulPenalty;
+        scores[UTF8_ENCODING_LATIN1] = 55 - nulPenalty;
+    }
+    else if( utf8Valid )
+    {
+        scores[UTF8_ENCODING_WINDOWS1252] = 30 - nulPenalty;
+        scores[UTF8_ENCODING_LATIN1] = 20 - nulPenalty;
+    }
+    else if( counters.undefined1252 != 0 )
+    {
+        // bytes with no Windows-1252 mapping point at genuine Latin-1 C1 controls
+        scores[UTF8_ENCODING_WINDOWS1252] = 40 - nulPenalty;
+        scores[UTF8_ENCODING_LATIN1] = 75 - nulPenalty;
+    }
+    else
+    {
+        // C1 bytes are printable punctuation in Windows-1252 but controls in Latin-1
+        scores[UTF8_ENCODING_WINDOWS1252] = 80 - nulPenalty;
+        scores[UTF8_ENCODING_LATIN1] = (counters.c1 != 0 ? 50 : 70) - nulPenalty;
+    }
+
+    if( bomEncoding != UTF8_ENCODING_UNKNOWN )
+    {
+        for( int encoding = 0; encoding != __UTF8_ENCODING_COUNT__; ++encoding )
+        {
+            scores[encoding] = scores[encoding] > 50 ? 50 : scores[encoding];
+        }
+
+        scores[bomEncoding] = 100;
+    }
+
+    for( int encoding = 0; encoding != __UTF8_ENCODING_COUNT__; ++encoding )
+    {
+        result.confidence[encoding] = __utf8_detect_clamp( scores[encoding] );
+    }
+
+    // rank by confidence (insertion sort keeps enum order for ties)
+    size_t ranked = 0;
+
+    for( int encoding = UTF8_ENCODING_UNKNOWN + 1; encoding != __UTF8_ENCODING_COUNT__; ++encoding )
+    {
+        size_t index = ranked++;
+
+        while( index != 0 && result.confidence[result.ranking[index - 1]] < result.confidence[encoding] )
+        {
+            result.ranking[index] = result.ranking[index - 1];
+            --index;
+        }
+
+        result.ranking[index] = (utf8_encoding_e)encoding;
+    }
+
+    utf8_encoding_e best = result.confidence[result.ranking[0]] != 0 ? result.ranking[0] : UTF8_ENCODING_UNKNOWN;
+
+    if( _result != NULL )
+    {
+        *_result = result;
+    }
+
+    return best;
+}
+//////////////////////////////////////////////////////////////////////////
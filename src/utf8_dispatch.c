@@ -0,0 +1,323 @@
+#include "utf8_internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#   define UTF8_X86
+#   if defined(_MSC_VER)
+#       include <immintrin.h>
+#   else
+#       include <cpuid.h>
+#   endif
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+size_t __utf8_ascii_prefix_scalar( const char * _utf8, const char * _utf8End )
+{
+    const char * p = _utf8;
+
+    for( ; p != _utf8End; ++p )
+    {
+        if( (uint8_t)*p >= 0x80 )
+        {
+            break;
+        }
+    }
+
+    return (size_t)(p - _utf8);
+}
+//////////////////////////////////////////////////////////////////////////
+size_t __utf8_printable_ascii_prefix_scalar( const char * _utf8, const char * _utf8End )
+{
+    const char * p = _utf8;
+
+    for( ; p != _utf8End; ++p )
+    {
+        uint8_t c = (uint8_t)*p;
+
+        if( c < 0x20 || c > 0x7E )
+        {
+            break;
+        }
+    }
+
+    return (size_t)(p - _utf8);
+}
+//////////////////////////////////////////////////////////////////////////
+const utf8_kernels_t __utf8_kernels_scalar = {
+    UTF8_ISA_SCALAR,
+    &__utf8_ascii_prefix_scalar,
+    &__utf8_printable_ascii_prefix_scalar
+};
+//////////////////////////////////////////////////////////////////////////
+static size_t __utf8_ascii_prefix_resolve( const char * _utf8, const char * _utf8End );
+static size_t __utf8_printable_ascii_prefix_resolve( const char * _utf8, const char * _utf8End );
+//////////////////////////////////////////////////////////////////////////
+// installed until the first call resolves the real table
+static const utf8_kernels_t __utf8_kernels_resolve = {
+    UTF8_ISA_AUTO,
+    &__utf8_ascii_prefix_resolve,
+    &__utf8_printable_ascii_prefix_resolve
+};
+//////////////////////////////////////////////////////////////////////////
+static const utf8_kernels_t * __utf8_kernels_active = &__utf8_kernels_resolve;
+//////////////////////////////////////////////////////////////////////////
+static const utf8_kernels_t * __utf8_kernels_load( void )
+{
+#if defined(_MSC_VER)
+    // a plain volatile read is not an acquire on ARM64; a no-op
+    // compare-exchange is a full barrier everywhere
+    return (const utf8_kernels_t *)_InterlockedCompareExchangePointer( (void * volatile *)&__utf8_kernels_active, NULL, NULL );
+#else
+    return __atomic_load_n( &__utf8_kernels_active, __ATOMIC_ACQUIRE );
+#endif
+}
+//////////////////////////////////////////////////////////////////////////
+static void __utf8_kernels_store( const utf8_kernels_t * _kernels )
+{
+#if defined(_MSC_VER)
+    _InterlockedExchangePointer( (void * volatile *)&__utf8_kernels_active, (void *)_kernels );
+#else
+    __atomic_store_n( &__utf8_kernels_active, _kernels, __ATOMIC_RELEASE );
+#endif
+}
+//////////////////////////////////////////////////////////////////////////
+static const utf8_kernels_t * __utf8_kernels_install( const utf8_kernels_t * _expected, const utf8_kernels_t * _kernels )
+{
+    // a forced selection made while another thread was resolving wins
+#if defined(_MSC_VER)
+    const utf8_kernels_t * previous = (const utf8_kernels_t *)_InterlockedCompareExchangePointer( (void * volatile *)&__utf8_kernels_active, (void *)_kernels, (void *)_expected );
+
+    return previous == _expected ? _kernels : previous;
+#else
+    const utf8_kernels_t * expected = _expected;
+
+    if( __atomic_compare_exchange_n( &__utf8_kernels_active, &expected, _kernels, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE ) == 0 )
+    {
+        return expected;
+    }
+
+    return _kernels;
+#endif
+}
+//////////////////////////////////////////////////////////////////////////
+#ifdef UTF8_X86
+//////////////////////////////////////////////////////////////////////////
+static void __utf8_cpuid( uint32_t _leaf, uint32_t _subleaf, uint32_t * const _regs )
+{
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuidex( regs, (int)_leaf, (int)_subleaf );
+
+    for( size_t index = 0; index != 4; ++index )
+    {
+        _regs[index] = (uint32_t)regs[index];
+    }
+#else
+    unsigned int a = 0, b = 0, c = 0, d = 0;
+    __cpuid_count( _leaf, _subleaf, a, b, c, d );
+
+    _regs[0] = a;
+    _regs[1] = b;
+    _regs[2] = c;
+    _regs[3] = d;
+#endif
+}
+//////////////////////////////////////////////////////////////////////////
+static uint64_t __utf8_xgetbv( void )
+{
+#if defined(_MSC_VER)
+    return (uint64_t)_xgetbv( 0 );
+#else
+    uint32_t lo, hi;
+    __asm__ __volatile__( "xgetbv" : "=a"( lo ), "=d"( hi ) : "c"( 0 ) );
+
+    return ((uint64_t)hi << 32) | lo;
+#endif
+}
+//////////////////////////////////////////////////////////////////////////
+#endif
+//////////////////////////////////////////////////////////////////////////
+static int __utf8_cpu_supports( utf8_isa_e _isa )
+{
+#ifdef UTF8_X86
+    uint32_t regs[4];
+    __utf8_cpuid( 0, 0, regs );
+
+    uint32_t maxLeaf = regs[0];
+
+    __utf8_cpuid( 1, 0, regs );
+
+    if( _isa == UTF8_ISA_SSE2 )
+    {
+        return (regs[3] >> 26) & 1;
+    }
+
+    // the OS must save the vector registers (OSXSAVE, then XCR0)
+    if( ((regs[2] >> 27) & 1) == 0 || maxLeaf < 7 )
+    {
+        return 0;
+    }
+
+    // leaf 7 reports AVX2 even where AVX itself is masked off (e.g. by a
+    // hypervisor), so the AVX bit from leaf 1 is required as well
+    uint32_t avx = (regs[2] >> 28) & 1;
+
+    uint64_t xcr0 = __utf8_xgetbv();
+
+    __utf8_cpuid( 7, 0, regs );
+
+    if( _isa == UTF8_ISA_AVX2 )
+    {
+        return avx != 0 && (xcr0 & 0x06) == 0x06 && ((regs[1] >> 5) & 1) != 0;
+    }
+
+    if( _isa == UTF8_ISA_AVX512 )
+    {
+        // AVX-512 F and BW, with opmask and ZMM state enabled
+        return avx != 0 && (xcr0 & 0xE6) == 0xE6 && ((regs[1] >> 16) & 1) != 0 && ((regs[1] >> 30) & 1) != 0;
+    }
+#else
+    (void)_isa;
+#endif
+
+    return 0;
+}
+//////////////////////////////////////////////////////////////////////////
+static const utf8_kernels_t * __utf8_kernels_for( utf8_isa_e _isa )
+{
+    switch( _isa )
+    {
+    case UTF8_ISA_SCALAR:
+        return &__utf8_kernels_scalar;
+#ifdef UTF8_SSE2
+    case UTF8_ISA_SSE2:
+        return __utf8_cpu_supports( UTF8_ISA_SSE2 ) != 0 ? &__utf8_kernels_sse2 : NULL;
+#endif
+#ifdef UTF8_HAVE_AVX2
+    case UTF8_ISA_AVX2:
+        return __utf8_cpu_supports( UTF8_ISA_AVX2 ) != 0 ? &__utf8_kernels_avx2 : NULL;
+#endif
+#ifdef UTF8_HAVE_AVX512
+    case UTF8_ISA_AVX512:
+        return __utf8_cpu_supports( UTF8_ISA_AVX512 ) != 0 ? &__utf8_kernels_avx512 : NULL;
+#endif
+    default:
+        return NULL;
+    }
+}
+//////////////////////////////////////////////////////////////////////////
+static const char * const __utf8_isa_names[__UTF8_ISA_COUNT__] = {
+    "auto",
+    "scalar",
+    "sse2",
+    "avx2",
+    "avx512"
+};
+//////////////////////////////////////////////////////////////////////////
+static const utf8_kernels_t * __utf8_kernels_default( void )
+{
+    const char * env = getenv( "UTF8_ISA" );
+
+    if( env != NULL )
+    {
+        for( int isa = UTF8_ISA_SCALAR; isa != __UTF8_ISA_COUNT__; ++isa )
+        {
+            if( strcmp( env, __utf8_isa_names[isa] ) == 0 )
+            {
+                const utf8_kernels_t * kernels = __utf8_kernels_for( (utf8_isa_e)isa );
+
+                if( kernels != NULL )
+                {
+                    return kernels;
+                }
+
+                break;
+            }
+        }
+    }
+
+    for( int isa = __UTF8_ISA_COUNT__ - 1; isa != UTF8_ISA_SCALAR; --isa )
+    {
+        const utf8_kernels_t * kernels = __utf8_kernels_for( (utf8_isa_e)isa );
+
+        if( kernels != NULL )
+        {
+            return kernels;
+        }
+    }
+
+    return &__utf8_kernels_scalar;
+}
+//////////////////////////////////////////////////////////////////////////
+static const utf8_kernels_t * __utf8_kernels_get( void )
+{
+    const utf8_kernels_t * kernels = __utf8_kernels_load();
+
+    if( kernels == &__utf8_kernels_resolve )
+    {
+        // racing threads compute the same table; the first store wins
+        kernels = __utf8_kernels_install( &__utf8_kernels_resolve, __utf8_kernels_default() );
+    }
+
+    return kernels;
+}
+//////////////////////////////////////////////////////////////////////////
+static size_t __utf8_ascii_prefix_resolve( const char * _utf8, const char * _utf8End )
+{
+    return __utf8_kernels_get()->ascii_prefix( _utf8, _utf8End );
+}
+//////////////////////////////////////////////////////////////////////////
+static size_t __utf8_printable_ascii_prefix_resolve( const char * _utf8, const char * _utf8End )
+{
+    return __utf8_kernels_get()->printable_ascii_prefix( _utf8, _utf8End );
+}
+//////////////////////////////////////////////////////////////////////////
+size_t __utf8_ascii_prefix( const char * _utf8, const char * _utf8End )
+{
+    return __utf8_kernels_load()->ascii_prefix( _utf8, _utf8End );
+}
+//////////////////////////////////////////////////////////////////////////
+size_t __utf8_printable_ascii_prefix( const char * _utf8, const char * _utf8End )
+{
+    return __utf8_kernels_load()->printable_ascii_prefix( _utf8, _utf8End );
+}
+//////////////////////////////////////////////////////////////////////////
+int utf8_isa_supported( utf8_isa_e _isa )
+{
+    if( _isa == UTF8_ISA_AUTO )
+    {
+        return 1;
+    }
+
+    return __utf8_kernels_for( _isa ) != NULL;
+}
+//////////////////////////////////////////////////////////////////////////
+utf8_isa_e utf8_isa_select( utf8_isa_e _isa )
+{
+    const utf8_kernels_t * kernels = _isa == UTF8_ISA_AUTO ? __utf8_kernels_default() : __utf8_kernels_for( _isa );
+
+    if( kernels != NULL )
+    {
+        __utf8_kernels_store( kernels );
+    }
+
+    return utf8_isa_active();
+}
+//////////////////////////////////////////////////////////////////////////
+utf8_isa_e utf8_isa_active( void )
+{
+    return __utf8_kernels_get()->isa;
+}
+//////////////////////////////////////////////////////////////////////////
+const char * utf8_isa_name( utf8_isa_e _isa )
+{
+    if( (int)_isa < 0 || _isa >= __UTF8_ISA_COUNT__ )
+    {
+        return NULL;
+    }
+
+    return __utf8_isa_names[_isa];
+}
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,383 @@
+#include "utf8_internal.h"
+
+//////////////////////////////////////////////////////////////////////////
+typedef enum utf8_grapheme_property_e
+{
+    UTF8_GCB_OTHER,
+    UTF8_GCB_CR,
+    UTF8_GCB_LF,
+    UTF8_GCB_CONTROL,
+    UTF8_GCB_EXTEND,
+    UTF8_GCB_ZWJ,
+    UTF8_GCB_REGIONAL_INDICATOR,
+    UTF8_GCB_PREPEND,
+    UTF8_GCB_SPACINGMARK,
+    UTF8_GCB_L,
+    UTF8_GCB_V,
+    UTF8_GCB_T,
+    UTF8_GCB_LV,
+    UTF8_GCB_EXTENDED_PICTOGRAPHIC,
+    UTF8_GCB_LVT
+} utf8_grapheme_property_e;
+//////////////////////////////////////////////////////////////////////////
+// Grapheme_Cluster_Break (and Extended_Pictographic) ranges, Unicode 14.0.
+// Each entry is (first_code_point << 4) | property and covers everything
+// up to the next entry. Precomposed Hangul syllables are stored as a single
+// LV range and split into LV/LVT arithmetically.
+//////////////////////////////////////////////////////////////////////////
+static const uint32_t __utf8_grapheme_ranges[] = {
+    0x0000003, 0x00000A2, 0x00000B3, 0x00000D1, 0x00000E3, 0x0000200, 0x00007F3, 0x0000A00,
+    0x0000A9D, 0x0000AA0, 0x0000AD3, 0x0000AED, 0x0000AF0, 0x0003004, 0x0003700, 0x0004834,
+    0x00048A0, 0x0005914, 0x0005BE0, 0x0005BF4, 0x0005C00, 0x0005C14, 0x0005C30, 0x0005C44,
+    0x0005C60, 0x0005C74, 0x0005C80, 0x0006007, 0x0006060, 0x0006104, 0x00061B0, 0x00061C3,
+    0x00061D0, 0x00064B4, 0x0006600, 0x0006704, 0x0006710, 0x0006D64, 0x0006DD7, 0x0006DE0,
+    0x0006DF4, 0x0006E50, 0x0006E74, 0x0006E90, 0x0006EA4, 0x0006EE0, 0x00070F7, 0x0007100,
+    0x0007114, 0x0007120, 0x0007304, 0x00074B0, 0x0007A64, 0x0007B10, 0x0007EB4, 0x0007F40,
+    0x0007FD4, 0x0007FE0, 0x0008164, 0x00081A0, 0x00081B4, 0x0008240, 0x0008254, 0x0008280,
+    0x0008294, 0x00082E0, 0x0008594, 0x00085C0, 0x0008907, 0x0008920, 0x0008984, 0x0008A00,
+    0x0008CA4, 0x0008E27, 0x0008E34, 0x0009038, 0x0009040, 0x00093A4, 0x00093B8, 0x00093C4,
+    0x00093D0, 0x00093E8, 0x0009414, 0x0009498, 0x00094D4, 0x00094E8, 0x0009500, 0x0009514,
+    0x0009580, 0x0009624, 0x0009640, 0x0009814, 0x0009828, 0x0009840, 0x0009BC4, 0x0009BD0,
+    0x0009BE4, 0x0009BF8, 0x0009C14, 0x0009C50, 0x0009C78, 0x0009C90, 0x0009CB8, 0x0009CD4,
+    0x0009CE0, 0x0009D74, 0x0009D80, 0x0009E24, 0x0009E40, 0x0009FE4, 0x0009FF0, 0x000A014,
+    0x000A038, 0x000A040, 0x000A3C4, 0x000A3D0, 0x000A3E8, 0x000A414, 0x000A430, 0x000A474,
+    0x000A490, 0x000A4B4, 0x000A4E0, 0x000A514, 0x000A520, 0x000A704, 0x000A720, 0x000A754,
+    0x000A760, 0x000A814, 0x000A838, 0x000A840, 0x000ABC4, 0x000ABD0, 0x000ABE8, 0x000AC14,
+    0x000AC60, 0x000AC74, 0x000AC98, 0x000ACA0, 0x000ACB8, 0x000ACD4, 0x000ACE0, 0x000AE24,
+    0x000AE40, 0x000AFA4, 0x000B000, 0x000B014, 0x000B028, 0x000B040, 0x000B3C4, 0x000B3D0,
+    0x000B3E4, 0x000B408, 0x000B414, 0x000B450, 0x000B478, 0x000B490, 0x000B4B8, 0x000B4D4,
+    0x000B4E0, 0x000B554, 0x000B580, 0x000B624, 0x000B640, 0x000B824, 0x000B830, 0x000BBE4,
+    0x000BBF8, 0x000BC04, 0x000BC18, 0x000BC30, 0x000BC68, 0x000BC90, 0x000BCA8, 0x000BCD4,
+    0x000BCE0, 0x000BD74, 0x000BD80, 0x000C004, 0x000C018, 0x000C044, 0x000C050, 0x000C3C4,
+    0x000C3D0, 0x000C3E4, 0x000C418, 0x000C450, 0x000C464, 0x000C490, 0x000C4A4, 0x000C4E0,
+    0x000C554, 0x000C570, 0x000C624, 0x000C640, 0x000C814, 0x000C828, 0x000C840, 0x000CBC4,
+    0x000CBD0, 0x000CBE8, 0x000CBF4, 0x000CC08, 0x000CC24, 0x000CC38, 0x000CC50, 0x000CC64,
+    0x000CC78, 0x000CC90, 0x000CCA8, 0x000CCC4, 0x000CCE0, 0x000CD54, 0x000CD70, 0x000CE24,
+    0x000CE40, 0x000D004, 0x000D028, 0x000D040, 0x000D3B4, 0x000D3D0, 0x000D3E4, 0x000D3F8,
+    0x000D414, 0x000D450, 0x000D468, 0x000D490, 0x000D4A8, 0x000D4D4, 0x000D4E7, 0x000D4F0,
+    0x000D574, 0x000D580, 0x000D624, 0x000D640, 0x000D814, 0x000D828, 0x000D840, 0x000DCA4,
+    0x000DCB0, 0x000DCF4, 0x000DD08, 0x000DD24, 0x000DD50, 0x000DD64, 0x000DD70, 0x000DD88,
+    0x000DDF4, 0x000DE00, 0x000DF28, 0x000DF40, 0x000E314, 0x000E320, 0x000E338, 0x000E344,
+    0x000E3B0, 0x000E474, 0x000E4F0, 0x000EB14, 0x000EB20, 0x000EB38, 0x000EB44, 0x000EBD0,
+    0x000EC84, 0x000ECE0, 0x000F184, 0x000F1A0, 0x000F354, 0x000F360, 0x000F374, 0x000F380,
+    0x000F394, 0x000F3A0, 0x000F3E8, 0x000F400, 0x000F714, 0x000F7F8, 0x000F804, 0x000F850,
+    0x000F864, 0x000F880, 0x000F8D4, 0x000F980, 0x000F994, 0x000FBD0, 0x000FC64, 0x000FC70,
+    0x00102D4, 0x0010318, 0x0010324, 0x0010380, 0x0010394, 0x00103B8, 0x00103D4, 0x00103F0,
+    0x0010568, 0x0010584, 0x00105A0, 0x00105E4, 0x0010610, 0x0010714, 0x0010750, 0x0010824,
+    0x0010830, 0x0010848, 0x0010854, 0x0010870, 0x00108D4, 0x00108E0, 0x00109D4, 0x00109E0,
+    0x0011009, 0x001160A, 0x0011A8B, 0x0012000, 0x00135D4, 0x0013600, 0x0017124, 0x0017158,
+    0x0017160, 0x0017324, 0x0017348, 0x0017350, 0x0017524, 0x0017540, 0x0017724, 0x0017740,
+    0x0017B44, 0x0017B68, 0x0017B74, 0x0017BE8, 0x0017C64, 0x0017C78, 0x0017C94, 0x0017D40,
+    0x0017DD4, 0x0017DE0, 0x00180B4, 0x00180E3, 0x00180F4, 0x0018100, 0x0018854, 0x0018870,
+    0x0018A94, 0x0018AA0, 0x0019204, 0x0019238, 0x0019274, 0x0019298, 0x00192C0, 0x0019308,
+    0x0019324, 0x0019338, 0x0019394, 0x00193C0, 0x001A174, 0x001A198, 0x001A1B4, 0x001A1C0,
+    0x001A558, 0x001A564, 0x001A578, 0x001A584, 0x001A5F0, 0x001A604, 0x001A610, 0x001A624,
+    0x001A630, 0x001A654, 0x001A6D8, 0x001A734, 0x001A7D0, 0x001A7F4, 0x001A800, 0x001AB04,
+    0x001ACF0, 0x001B004, 0x001B048, 0x001B050, 0x001B344, 0x001B3B8, 0x001B3C4, 0x001B3D8,
+    0x001B424, 0x001B438, 0x001B450, 0x001B6B4, 0x001B740, 0x001B804, 0x001B828, 0x001B830,
+    0x001BA18, 0x001BA24, 0x001BA68, 0x001BA84, 0x001BAA8, 0x001BAB4, 0x001BAE0, 0x001BE64,
+    0x001BE78, 0x001BE84, 0x001BEA8, 0x001BED4, 0x001BEE8, 0x001BEF4, 0x001BF28, 0x001BF40,
+    0x001C248, 0x001C2C4, 0x001C348, 0x001C364, 0x001C380, 0x001CD04, 0x001CD30, 0x001CD44,
+    0x001CE18, 0x001CE24, 0x001CE90, 0x001CED4, 0x001CEE0, 0x001CF44, 0x001CF50, 0x001CF78,
+    0x001CF84, 0x001CFA0, 0x001DC04, 0x001E000, 0x00200B3, 0x00200C4, 0x00200D5, 0x00200E3,
+    0x0020100, 0x0020283, 0x00202F0, 0x00203CD, 0x00203D0, 0x002049D, 0x00204A0, 0x0020603,
+    0x0020650, 0x0020663, 0x0020700, 0x0020D04, 0x0020F10, 0x002122D, 0x0021230, 0x002139D,
+    0x00213A0, 0x002194D, 0x00219A0, 0x0021A9D, 0x0021AB0, 0x00231AD, 0x00231C0, 0x002328D,
+    0x0023290, 0x002388D, 0x0023890, 0x0023CFD, 0x0023D00, 0x0023E9D, 0x0023F40, 0x0023F8D,
+    0x0023FB0, 0x0024C2D, 0x0024C30, 0x0025AAD, 0x0025AC0, 0x0025B6D, 0x0025B70, 0x0025C0D,
+    0x0025C10, 0x0025FBD, 0x0025FF0, 0x002600D, 0x0026060, 0x002607D, 0x0026130, 0x002614D,
+    0x0026860, 0x002690D, 0x0027060, 0x002708D, 0x0027130, 0x002714D, 0x0027150, 0x002716D,
+    0x0027170, 0x00271DD, 0x00271E0, 0x002721D, 0x0027220, 0x002728D, 0x0027290, 0x002733D,
+    0x0027350, 0x002744D, 0x0027450, 0x002747D, 0x0027480, 0x00274CD, 0x00274D0, 0x00274ED,
+    0x00274F0, 0x002753D, 0x0027560, 0x002757D, 0x0027580, 0x002763D, 0x0027680, 0x002795D,
+    0x0027980, 0x0027A1D, 0x0027A20, 0x0027B0D, 0x0027B10, 0x0027BFD, 0x0027C00, 0x002934D,
+    0x0029360, 0x002B05D, 0x002B080, 0x002B1BD, 0x002B1D0, 0x002B50D, 0x002B510, 0x002B55D,
+    0x002B560, 0x002CEF4, 0x002CF20, 0x002D7F4, 0x002D800, 0x002DE04, 0x002E000, 0x00302A4,
+    0x003030D, 0x0030310, 0x00303DD, 0x00303E0, 0x0030994, 0x00309B0, 0x003297D, 0x0032980,
+    0x003299D, 0x00329A0, 0x00A66F4, 0x00A6730, 0x00A6744, 0x00A67E0, 0x00A69E4, 0x00A6A00,
+    0x00A6F04, 0x00A6F20, 0x00A8024, 0x00A8030, 0x00A8064, 0x00A8070, 0x00A80B4, 0x00A80C0,
+    0x00A8238, 0x00A8254, 0x00A8278, 0x00A8280, 0x00A82C4, 0x00A82D0, 0x00A8808, 0x00A8820,
+    0x00A8B48, 0x00A8C44, 0x00A8C60, 0x00A8E04, 0x00A8F20, 0x00A8FF4, 0x00A9000, 0x00A9264,
+    0x00A92E0, 0x00A9474, 0x00A9528, 0x00A9540, 0x00A9609, 0x00A97D0, 0x00A9804, 0x00A9838,
+    0x00A9840, 0x00A9B34, 0x00A9B48, 0x00A9B64, 0x00A9BA8, 0x00A9BC4, 0x00A9BE8, 0x00A9C10,
+    0x00A9E54, 0x00A9E60, 0x00AA294, 0x00AA2F8, 0x00AA314, 0x00AA338, 0x00AA354, 0x00AA370,
+    0x00AA434, 0x00AA440, 0x00AA4C4, 0x00AA4D8, 0x00AA4E0, 0x00AA7C4, 0x00AA7D0, 0x00AAB04,
+    0x00AAB10, 0x00AAB24, 0x00AAB50, 0x00AAB74, 0x00AAB90, 0x00AABE4, 0x00AAC00, 0x00AAC14,
+    0x00AAC20, 0x00AAEB8, 0x00AAEC4, 0x00AAEE8, 0x00AAF00, 0x00AAF58, 0x00AAF64, 0x00AAF70,
+    0x00ABE38, 0x00ABE54, 0x00ABE68, 0x00ABE84, 0x00ABE98, 0x00ABEB0, 0x00ABEC8, 0x00ABED4,
+    0x00ABEE0, 0x00AC00C, 0x00D7A40, 0x00D7B0A, 0x00D7C70, 0x00D7CBB, 0x00D7FC0, 0x00FB1E4,
+    0x00FB1F0, 0x00FE004, 0x00FE100, 0x00FE204, 0x00FE300, 0x00FEFF3, 0x00FF000, 0x00FF9E4,
+    0x00FFA00, 0x00FFF93, 0x00FFFC0, 0x0101FD4, 0x0101FE0, 0x0102E04, 0x0102E10, 0x0103764,
+    0x01037B0, 0x010A014, 0x010A040, 0x010A054, 0x010A070, 0x010A0C4, 0x010A100, 0x010A384,
+    0x010A3B0, 0x010A3F4, 0x010A400, 0x010AE54, 0x010AE70, 0x010D244, 0x010D280, 0x010EAB4,
+    0x010EAD0, 0x010F464, 0x010F510, 0x010F824, 0x010F860, 0x0110008, 0x0110014, 0x0110028,
+    0x0110030, 0x0110384, 0x0110470, 0x0110704, 0x0110710, 0x0110734, 0x0110750, 0x01107F4,
+    0x0110828, 0x0110830, 0x0110B08, 0x0110B34, 0x0110B78, 0x0110B94, 0x0110BB0, 0x0110BD7,
+    0x0110BE0, 0x0110C24, 0x0110C30, 0x0110CD7, 0x0110CE0, 0x0111004, 0x0111030, 0x0111274,
+    0x01112C8, 0x01112D4, 0x0111350, 0x0111458, 0x0111470, 0x0111734, 0x0111740, 0x0111804,
+    0x0111828, 0x0111830, 0x0111B38, 0x0111B64, 0x0111BF8, 0x0111C10, 0x0111C27, 0x0111C40,
+    0x0111C94, 0x0111CD0, 0x0111CE8, 0x0111CF4, 0x0111D00, 0x01122C8, 0x01122F4, 0x0112328,
+    0x0112344, 0x0112358, 0x0112364, 0x0112380, 0x01123E4, 0x01123F0, 0x0112DF4, 0x0112E08,
+    0x0112E34, 0x0112EB0, 0x0113004, 0x0113028, 0x0113040, 0x01133B4, 0x01133D0, 0x01133E4,
+    0x01133F8, 0x0113404, 0x0113418, 0x0113450, 0x0113478, 0x0113490, 0x01134B8, 0x01134E0,
+    0x0113574, 0x0113580, 0x0113628, 0x0113640, 0x0113664, 0x01136D0, 0x0113704, 0x0113750,
+    0x0114358, 0x0114384, 0x0114408, 0x0114424, 0x0114458, 0x0114464, 0x0114470, 0x01145E4,
+    0x01145F0, 0x0114B04, 0x0114B18, 0x0114B34, 0x0114B98, 0x0114BA4, 0x0114BB8, 0x0114BD4,
+    0x0114BE8, 0x0114BF4, 0x0114C18, 0x0114C24, 0x0114C40, 0x0115AF4, 0x0115B08, 0x0115B24,
+    0x0115B60, 0x0115B88, 0x0115BC4, 0x0115BE8, 0x0115BF4, 0x0115C10, 0x0115DC4, 0x0115DE0,
+    0x0116308, 0x0116334, 0x01163B8, 0x01163D4, 0x01163E8, 0x01163F4, 0x0116410, 0x0116AB4,
+    0x0116AC8, 0x0116AD4, 0x0116AE8, 0x0116B04, 0x0116B68, 0x0116B74, 0x0116B80, 0x01171D4,
+    0x0117200, 0x0117224, 0x0117268, 0x0117274, 0x01172C0, 0x01182C8, 0x01182F4, 0x0118388,
+    0x0118394, 0x01183B0, 0x0119304, 0x0119318, 0x0119360, 0x0119378, 0x0119390, 0x01193B4,
+    0x01193D8, 0x01193E4, 0x01193F7, 0x0119408, 0x0119417, 0x0119428, 0x0119434, 0x0119440,
+    0x0119D18, 0x0119D44, 0x0119D80, 0x0119DA4, 0x0119DC8, 0x0119E04, 0x0119E10, 0x0119E48,
+    0x0119E50, 0x011A014, 0x011A0B0, 0x011A334, 0x011A398, 0x011A3A7, 0x011A3B4, 0x011A3F0,
+    0x011A474, 0x011A480, 0x011A514, 0x011A578, 0x011A594, 0x011A5C0, 0x011A847, 0x011A8A4,
+    0x011A978, 0x011A984, 0x011A9A0, 0x011C2F8, 0x011C304, 0x011C370, 0x011C384, 0x011C3E8,
+    0x011C3F4, 0x011C400, 0x011C924, 0x011CA80, 0x011CA98, 0x011CAA4, 0x011CB18, 0x011CB24,
+    0x011CB48, 0x011CB54, 0x011CB70, 0x011D314, 0x011D370, 0x011D3A4, 0x011D3B0, 0x011D3C4,
+    0x011D3E0, 0x011D3F4, 0x011D467, 0x011D474, 0x011D480, 0x011D8A8, 0x011D8F0, 0x011D904,
+    0x011D920, 0x011D938, 0x011D954, 0x011D968, 0x011D974, 0x011D980, 0x011EF34, 0x011EF58,
+    0x011EF70, 0x0134303, 0x0134390, 0x016AF04, 0x016AF50, 0x016B304, 0x016B370, 0x016F4F4,
+    0x016F500, 0x016F518, 0x016F880, 0x016F8F4, 0x016F930, 0x016FE44, 0x016FE50, 0x016FF08,
+    0x016FF20, 0x01BC9D4, 0x01BC9F0, 0x01BCA03, 0x01BCA40, 0x01CF004, 0x01CF2E0, 0x01CF304,
+    0x01CF470, 0x01D1654, 0x01D1668, 0x01D1674, 0x01D16A0, 0x01D16D8, 0x01D16E4, 0x01D1733,
+    0x01D17B4, 0x01D1830, 0x01D1854, 0x01D18C0, 0x01D1AA4, 0x01D1AE0, 0x01D2424, 0x01D2450,
+    0x01DA004, 0x01DA370, 0x01DA3B4, 0x01DA6D0, 0x01DA754, 0x01DA760, 0x01DA844, 0x01DA850,
+    0x01DA9B4, 0x01DAA00, 0x01DAA14, 0x01DAB00, 0x01E0004, 0x01E0070, 0x01E0084, 0x01E0190,
+    0x01E01B4, 0x01E0220, 0x01E0234, 0x01E0250, 0x01E0264, 0x01E02B0, 0x01E1304, 0x01E1370,
+    0x01E2AE4, 0x01E2AF0, 0x01E2EC4, 0x01E2F00, 0x01E8D04, 0x01E8D70, 0x01E9444, 0x01E94B0,
+    0x01F000D, 0x01F1000, 0x01F10DD, 0x01F1100, 0x01F12FD, 0x01F1300, 0x01F16CD, 0x01F1720,
+    0x01F17ED, 0x01F1800, 0x01F18ED, 0x01F18F0, 0x01F191D, 0x01F19B0, 0x01F1ADD, 0x01F1E66,
+    0x01F2000, 0x01F201D, 0x01F2100, 0x01F21AD, 0x01F21B0, 0x01F22FD, 0x01F2300, 0x01F232D,
+    0x01F23B0, 0x01F23CD, 0x01F2400, 0x01F249D, 0x01F3FB4, 0x01F400D, 0x01F53E0, 0x01F546D,
+    0x01F6500, 0x01F680D, 0x01F7000, 0x01F774D, 0x01F7800, 0x01F7D5D, 0x01F8000, 0x01F80CD,
+    0x01F8100, 0x01F848D, 0x01F8500, 0x01F85AD, 0x01F8600, 0x01F888D, 0x01F8900, 0x01F8AED,
+    0x01F9000, 0x01F90CD, 0x01F93B0, 0x01F93CD, 0x01F9460, 0x01F947D, 0x01FB000, 0x01FC00D,
+    0x01FFFE0, 0x0E00003, 0x0E00204, 0x0E00803, 0x0E01004, 0x0E01F03, 0x0E10000,
+};
+//////////////////////////////////////////////////////////////////////////
+#define UTF8_HANGUL_SYLLABLE_BASE  (0xAC00)
+#define UTF8_HANGUL_SYLLABLE_COUNT (11172)
+#define UTF8_HANGUL_T_COUNT        (28)
+//////////////////////////////////////////////////////////////////////////
+static utf8_grapheme_property_e __utf8_grapheme_property( uint32_t _code )
+{
+    size_t lo = 0;
+    size_t hi = sizeof( __utf8_grapheme_ranges ) / sizeof( __utf8_grapheme_ranges[0] );
+
+    while( hi - lo > 1 )
+    {
+        size_t mid = (lo + hi) / 2;
+
+        if( (__utf8_grapheme_ranges[mid] >> 4) <= _code )
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    utf8_grapheme_property_e property = (utf8_grapheme_property_e)(__utf8_grapheme_ranges[lo] & 0x0F);
+
+    if( property == UTF8_GCB_LV && (_code - UTF8_HANGUL_SYLLABLE_BASE) % UTF8_HANGUL_T_COUNT != 0 )
+    {
+        return UTF8_GCB_LVT;
+    }
+
+    return property;
+}
+//////////////////////////////////////////////////////////////////////////
+static utf8_grapheme_property_e __utf8_grapheme_ascii_property( uint32_t _code )
+{
+    if( _code == 0x0D )
+    {
+        return UTF8_GCB_CR;
+    }
+    else if( _code == 0x0A )
+    {
+        return UTF8_GCB_LF;
+    }
+    else if( _code < 0x20 || _code == 0x7F )
+    {
+        return UTF8_GCB_CONTROL;
+    }
+
+    return UTF8_GCB_OTHER;
+}
+//////////////////////////////////////////////////////////////////////////
+static const char * __utf8_next_property( const char * _utf8, const char * _utf8End, utf8_grapheme_property_e * const _property )
+{
+    uint8_t c = (uint8_t)*_utf8;
+
+    if( c < 0x80 )
+    {
+        *_property = __utf8_grapheme_ascii_property( c );
+
+        return _utf8 + 1;
+    }
+
+    uint32_t code;
+    const char * next = utf8_next_code( _utf8, _utf8End, &code );
+
+    if( next == NULL )
+    {
+        return NULL;
+    }
+
+    *_property = __utf8_grapheme_property( code );
+
+    return next;
+}
+//////////////////////////////////////////////////////////////////////////
+static int __utf8_grapheme_is_control( utf8_grapheme_property_e _property )
+{
+    return _property == UTF8_GCB_CONTROL || _property == UTF8_GCB_CR || _property == UTF8_GCB_LF;
+}
+//////////////////////////////////////////////////////////////////////////
+const char * utf8_next_grapheme( const char * _utf8, const char * _utf8End )
+{
+    if( _utf8 == NULL || _utf8 == _utf8End )
+    {
+        return NULL;
+    }
+
+    uint8_t c0 = (uint8_t)_utf8[0];
+
+    if( c0 >= 0x20 && c0 < 0x7F && (_utf8 + 1 == _utf8End || (uint8_t)_utf8[1] < 0x80) )
+    {
+        // printable ASCII followed by ASCII always ends a cluster
+        return _utf8 + 1;
+    }
+
+    utf8_grapheme_property_e prev;
+    const char * p = __utf8_next_property( _utf8, _utf8End, &prev );
+
+    if( p == NULL )
+    {
+        return NULL;
+    }
+
+    int emoji = (prev == UTF8_GCB_EXTENDED_PICTOGRAPHIC);
+    int emojiZwj = 0;
+    size_t regional = (prev == UTF8_GCB_REGIONAL_INDICATOR);
+
+    while( p != _utf8End )
+    {
+        utf8_grapheme_property_e next;
+        const char * p_next = __utf8_next_property( p, _utf8End, &next );
+
+        if( p_next == NULL )
+        {
+            break;
+        }
+
+        int join;
+
+        if( prev == UTF8_GCB_CR && next == UTF8_GCB_LF )
+        {
+            join = 1; // GB3
+        }
+        else if( __utf8_grapheme_is_control( prev ) || __utf8_grapheme_is_control( next ) )
+        {
+            join = 0; // GB4, GB5
+        }
+        else if( prev == UTF8_GCB_L && (next == UTF8_GCB_L || next == UTF8_GCB_V || next == UTF8_GCB_LV || next == UTF8_GCB_LVT) )
+        {
+            join = 1; // GB6
+        }
+        else if( (prev == UTF8_GCB_LV || prev == UTF8_GCB_V) && (next == UTF8_GCB_V || next == UTF8_GCB_T) )
+        {
+            join = 1; // GB7
+        }
+        else if( (prev == UTF8_GCB_LVT || prev == UTF8_GCB_T) && next == UTF8_GCB_T )
+        {
+            join = 1; // GB8
+        }
+        else if( next == UTF8_GCB_EXTEND || next == UTF8_GCB_ZWJ || next == UTF8_GCB_SPACINGMARK )
+        {
+            join = 1; // GB9, GB9a
+        }
+        else if( prev == UTF8_GCB_PREPEND )
+        {
+            join = 1; // GB9b
+        }
+        else if( emojiZwj == 1 && prev == UTF8_GCB_ZWJ && next == UTF8_GCB_EXTENDED_PICTOGRAPHIC )
+        {
+            join = 1; // GB11
+        }
+        else if( prev == UTF8_GCB_REGIONAL_INDICATOR && next == UTF8_GCB_REGIONAL_INDICATOR && regional % 2 == 1 )
+        {
+            join = 1; // GB12, GB13
+        }
+        else
+        {
+            join = 0; // GB999
+        }
+
+        if( join == 0 )
+        {
+            break;
+        }
+
+        // GB11 tracks ExtPict Extend* ZWJ within the cluster
+        if( next == UTF8_GCB_EXTENDED_PICTOGRAPHIC )
+        {
+            emoji = 1;
+            emojiZwj = 0;
+        }
+        else if( next == UTF8_GCB_ZWJ )
+        {
+            emojiZwj = emoji;
+            emoji = 0;
+        }
+        else if( next != UTF8_GCB_EXTEND )
+        {
+            emoji = 0;
+            emojiZwj = 0;
+        }
+
+        if( next == UTF8_GCB_REGIONAL_INDICATOR )
+        {
+            ++regional;
+        }
+
+        prev = next;
+        p = p_next;
+    }
+
+    return p;
+}
+//////////////////////////////////////////////////////////////////////////
+size_t utf8_grapheme_count( const char * _utf8, const char * _utf8End )
+{
+    size_t count = 0;
+
+    for( const char * p = _utf8; p != _utf8End; )
+    {
+        size_t ascii = __utf8_printable_ascii_prefix( p, _utf8End );
+
+        if( ascii > 1 )
+        {
+            // every printable ASCII byte but the last is its own cluster;
+            // the last one may still be extended by a following mark
+            count += ascii - 1;
+            p += ascii - 1;
+        }
+
+        const char * next = utf8_next_grapheme( p, _utf8End );
+
+        if( next == NULL )
+        {
+            return UTF8_UNKNOWN;
+        }
+
+        ++count;
+        p = next;
+    }
+
+    return count;
+}
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,273 @@
+#ifndef UTF8_INTERNAL_H_
+#define UTF8_INTERNAL_H_
+
+#include "utf8/utf8.h"
+
+//////////////////////////////////////////////////////////////////////////
+#define UTF8_REPLACEMENT_CHARACTER (0xFFFD)
+#define UTF8_SURROGATE_LO          (0xD800)
+#define UTF8_SURROGATE_HI          (0xDFFF)
+#define UTF8_MAX_CODE_POINT        (0x10FFFF)
+//////////////////////////////////////////////////////////////////////////
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define UTF8_SSE2
+#endif
+//////////////////////////////////////////////////////////////////////////
+#define UTF8_SMALL_STRING_SIZE (32)
+//////////////////////////////////////////////////////////////////////////
+#include <string.h>
+
+#if defined(_MSC_VER)
+#   include <intrin.h>
+#endif
+//////////////////////////////////////////////////////////////////////////
+static inline uint32_t __utf8_ctz32( uint32_t _value )
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward( &index, _value );
+
+    return (uint32_t)index;
+#else
+    return (uint32_t)__builtin_ctz( _value );
+#endif
+}
+//////////////////////////////////////////////////////////////////////////
+static inline uint32_t __utf8_ctz64( uint64_t _value )
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long index;
+    _BitScanForward64( &index, _value );
+
+    return (uint32_t)index;
+#elif defined(_MSC_VER)
+    // _BitScanForward64 only exists on 64-bit targets
+    if( (uint32_t)_value != 0 )
+    {
+        return __utf8_ctz32( (uint32_t)_value );
+    }
+
+    return 32 + __utf8_ctz32( (uint32_t)(_value >> 32) );
+#else
+    return (uint32_t)__builtin_ctzll( _value );
+#endif
+}
+//////////////////////////////////////////////////////////////////////////
+static inline uint32_t __utf8_popcount32( uint32_t _value )
+{
+#if defined(_MSC_VER)
+    _value = _value - ((_value >> 1) & 0x55555555U);
+    _value = (_value & 0x33333333U) + ((_value >> 2) & 0x33333333U);
+
+    return (((_value + (_value >> 4)) & 0x0F0F0F0FU) * 0x01010101U) >> 24;
+#else
+    return (uint32_t)__builtin_popcount( _value );
+#endif
+}
+//////////////////////////////////////////////////////////////////////////
+static inline uint64_t __utf8_load64( const char * _utf8 )
+{
+    uint64_t value;
+    memcpy( &value, _utf8, sizeof( value ) );
+
+    return value;
+}
+//////////////////////////////////////////////////////////////////////////
+static inline uint32_t __utf8_load32( const char * _utf8 )
+{
+    uint32_t value;
+    memcpy( &value, _utf8, sizeof( value ) );
+
+    return value;
+}
+//////////////////////////////////////////////////////////////////////////
+#define UTF8_HIGH_BITS64 (0x8080808080808080ULL)
+//////////////////////////////////////////////////////////////////////////
+/**
+ * ORs together a string of at most UTF8_SMALL_STRING_SIZE bytes using a few
+ * overlapping loads that stay inside [_utf8, _utf8 + _size). Some byte has
+ * its high bit set iff the result has one under UTF8_HIGH_BITS64.
+ */
+static inline uint64_t __utf8_small_high_bits( const char * _utf8, size_t _size )
+{
+    if( _size >= 16 )
+    {
+        return __utf8_load64( _utf8 ) | __utf8_load64( _utf8 + 8 ) | __utf8_load64( _utf8 + _size - 16 ) | __utf8_load64( _utf8 + _size - 8 );
+    }
+    else if( _size >= 8 )
+    {
+        return __utf8_load64( _utf8 ) | __utf8_load64( _utf8 + _size - 8 );
+    }
+    else if( _size >= 4 )
+    {
+        return __utf8_load32( _utf8 ) | __utf8_load32( _utf8 + _size - 4 );
+    }
+    else if( _size != 0 )
+    {
+        return (uint8_t)_utf8[0] | (uint8_t)_utf8[_size / 2] | (uint8_t)_utf8[_size - 1];
+    }
+
+    return 0;
+}
+//////////////////////////////////////////////////////////////////////////
+/**
+ * Checks whether a string of at most UTF8_SMALL_STRING_SIZE bytes is pure
+ * ASCII.
+ */
+static inline int __utf8_small_is_ascii( const char * _utf8, size_t _size )
+{
+    return (__utf8_small_high_bits( _utf8, _size ) & UTF8_HIGH_BITS64) == 0;
+}
+//////////////////////////////////////////////////////////////////////////
+/**
+ * Same check for at most UTF8_SMALL_STRING_SIZE wchar_t units. Every load
+ * starts on a unit boundary, so each unit fills whole lanes of the word.
+ */
+static inline int __utf8_small_wide_is_ascii( const wchar_t * _unicode, size_t _size )
+{
+    const uint64_t mask = sizeof( wchar_t ) == 2 ? 0xFF80FF80FF80FF80ULL : 0xFFFFFF80FFFFFF80ULL;
+
+    const char * p = (const char *)_unicode;
+    size_t bytes = _size * sizeof( wchar_t );
+
+    if( bytes < 8 )
+    {
+        uint32_t bits = 0;
+
+        for( size_t index = 0; index != _size; ++index )
+        {
+            bits |= (uint32_t)_unicode[index];
+        }
+
+        return bits < 0x80;
+    }
+
+    uint64_t bits = __utf8_load64( p + bytes - 8 );
+
+    for( size_t offset = 0; offset + 8 < bytes; offset += 8 )
+    {
+        bits |= __utf8_load64( p + offset );
+    }
+
+    return (bits & mask) == 0;
+}
+//////////////////////////////////////////////////////////////////////////
+/**
+ * Output cursor for transforms with a sizing pass: with out == NULL it only
+ * counts bytes, otherwise it fails once capacity would be exceeded.
+ */
+typedef struct utf8_writer_t
+{
+    char * out;
+    size_t capacity;
+    size_t size;
+} utf8_writer_t;
+//////////////////////////////////////////////////////////////////////////
+static inline int __utf8_writer_write( utf8_writer_t * const _writer, const char * _data, size_t _size )
+{
+    if( _writer->out != NULL )
+    {
+        if( _size > _writer->capacity - _writer->size )
+        {
+            return 0;
+        }
+
+        memcpy( _writer->out + _writer->size, _data, _size );
+    }
+
+    _writer->size += _size;
+
+    return 1;
+}
+//////////////////////////////////////////////////////////////////////////
+/**
+ * What a call saw, reported by the uninstrumented cores to the public
+ * wrappers: end of the UTF-8 consumed or produced, how much of it was ASCII
+ * and whether the small-string check settled it.
+ */
+typedef struct utf8_trace_t
+{
+    const char * end;
+    size_t ascii;
+    int small;
+} utf8_trace_t;
+//////////////////////////////////////////////////////////////////////////
+static inline void __utf8_trace_set( utf8_trace_t * const _trace, const char * _end, size_t _ascii, int _small )
+{
+    if( _trace != NULL )
+    {
+        _trace->end = _end;
+        _trace->ascii = _ascii;
+        _trace->small = _small;
+    }
+}
+//////////////////////////////////////////////////////////////////////////
+/**
+ * Cores of utf8_validate(), utf8_to_unicodez() and utf8_from_unicodez()
+ * without instrumentation, for use inside the library; _trace may be NULL.
+ */
+const char * __utf8_validate( const char * _utf8, const char * _utf8End, utf8_trace_t * const _trace );
+size_t __utf8_to_unicodez( const char * _utf8, size_t _utf8Size, wchar_t * const _unicode, size_t _unicodeCapacity, utf8_trace_t * const _trace );
+size_t __utf8_from_unicodez( const wchar_t * _unicode, size_t _unicodeSize, char * const _utf8, size_t _utf8Capacity, utf8_trace_t * const _trace );
+//////////////////////////////////////////////////////////////////////////
+#ifdef UTF8_ENABLE_STATS
+/**
+ * Calls the begin hook; returns the hooks the matching end must report to.
+ */
+const utf8_stats_hooks_t * __utf8_stats_begin( utf8_stats_function_e _function );
+
+/**
+ * Records one call of an instrumented function; [_utf8, _utf8End) is the
+ * UTF-8 data it consumed or produced, _asciiBytes the part of it the
+ * function's own loop saw as ASCII and _path the path that settled it.
+ */
+void __utf8_stats_record( const utf8_stats_hooks_t * _hooks, utf8_stats_function_e _function, const char * _utf8, const char * _utf8End, size_t _asciiBytes, utf8_stats_path_e _path, int _error );
+#   define UTF8_STATS_BEGIN( Function ) const utf8_stats_hooks_t * utf8StatsHooks = __utf8_stats_begin( Function )
+#   define UTF8_STATS_RECORD( Function, Begin, End, AsciiBytes, Path, Error ) __utf8_stats_record( utf8StatsHooks, Function, Begin, End, AsciiBytes, Path, Error )
+#else
+#   define UTF8_STATS_BEGIN( Function ) ((void)0)
+#   define UTF8_STATS_RECORD( Function, Begin, End, AsciiBytes, Path, Error ) ((void)(AsciiBytes), (void)(Error))
+#endif
+//////////////////////////////////////////////////////////////////////////
+/**
+ * Returns the length of the leading run of ASCII bytes (< 0x80)
+ * in [_utf8, _utf8End). Dispatched to the active ISA.
+ */
+size_t __utf8_ascii_prefix( const char * _utf8, const char * _utf8End );
+//////////////////////////////////////////////////////////////////////////
+/**
+ * Returns the length of the leading run of printable ASCII bytes
+ * (0x20..0x7E) in [_utf8, _utf8End). Dispatched to the active ISA.
+ */
+size_t __utf8_printable_ascii_prefix( const char * _utf8, const char * _utf8End );
+//////////////////////////////////////////////////////////////////////////
+/**
+ * One implementation of every dispatched kernel. The AVX2 and AVX-512
+ * tables live in files built with their own ISA flags and are only present
+ * when CMake defines UTF8_HAVE_AVX2 / UTF8_HAVE_AVX512.
+ */
+typedef struct utf8_kernels_t
+{
+    utf8_isa_e isa;
+    size_t (*ascii_prefix)( const char * _utf8, const char * _utf8End );
+    size_t (*printable_ascii_prefix)( const char * _utf8, const char * _utf8End );
+} utf8_kernels_t;
+//////////////////////////////////////////////////////////////////////////
+/**
+ * Portable kernels; the vector kernels use them for their tails.
+ */
+size_t __utf8_ascii_prefix_scalar( const char * _utf8, const char * _utf8End );
+size_t __utf8_printable_ascii_prefix_scalar( const char * _utf8, const char * _utf8End );
+//////////////////////////////////////////////////////////////////////////
+extern const utf8_kernels_t __utf8_kernels_scalar;
+#ifdef UTF8_SSE2
+extern const utf8_kernels_t __utf8_kernels_sse2;
+#endif
+#ifdef UTF8_HAVE_AVX2
+extern const utf8_kernels_t __utf8_kernels_avx2;
+#endif
+#ifdef UTF8_HAVE_AVX512
+extern const utf8_kernels_t __utf8_kernels_avx512;
+#endif
+//////////////////////////////////////////////////////////////////////////
+#endif
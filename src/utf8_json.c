@@ -0,0 +1,368 @@
+#include "utf8_internal.h"
+
+#include <string.h>
+
+#ifdef UTF8_SSE2
+#   include <emmintrin.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+static const char __utf8_json_hex[] = "0123456789abcdef";
+//////////////////////////////////////////////////////////////////////////
+static size_t __utf8_json_clean_prefix( const char * _utf8, const char * _utf8End )
+{
+    const char * p = _utf8;
+
+#ifdef UTF8_SSE2
+    const __m128i quote = _mm_set1_epi8( '"' );
+    const __m128i backslash = _mm_set1_epi8( '\\' );
+    const __m128i space = _mm_set1_epi8( 0x20 );
+
+    for( ; _utf8End - p >= 16; p += 16 )
+    {
+        __m128i v = _mm_loadu_si128( (const __m128i *)p );
+
+        // signed compare catches both control characters and non-ASCII bytes
+        __m128i special = _mm_or_si128( _mm_cmplt_epi8( v, space ), _mm_or_si128( _mm_cmpeq_epi8( v, quote ), _mm_cmpeq_epi8( v, backslash ) ) );
+
+        uint32_t mask = (uint32_t)_mm_movemask_epi8( special );
+
+        if( mask != 0 )
+        {
+            return (size_t)(p - _utf8) + __utf8_ctz32( mask );
+        }
+    }
+#endif
+
+    for( ; p != _utf8End; ++p )
+    {
+        uint8_t c = (uint8_t)*p;
+
+        if( c < 0x20 || c >= 0x80 || c == '"' || c == '\\' )
+        {
+            break;
+        }
+    }
+
+    return (size_t)(p - _utf8);
+}
+//////////////////////////////////////////////////////////////////////////
+static size_t __utf8_json_clean_run( const char * _utf8, const char * _utf8End, uint32_t _flags )
+{
+    // unless non-ASCII is escaped, valid multibyte sequences stay in the run
+    const char * p = _utf8;
+
+    for( ;; )
+    {
+        p += __utf8_json_clean_prefix( p, _utf8End );
+
+        if( p == _utf8End || (uint8_t)*p < 0x80 || (_flags & UTF8_JSON_ESCAPE_ASCII) != 0 )
+        {
+            break;
+        }
+
+        const char * next = utf8_next_code( p, _utf8End, NULL );
+
+        if( next == NULL )
+        {
+            break;
+        }
+
+        p = next;
+    }
+
+    return (size_t)(p - _utf8);
+}
+//////////////////////////////////////////////////////////////////////////
+static char * __utf8_json_append_u16( char * _out, uint32_t _code )
+{
+    _out[0] = '\\';
+    _out[1] = 'u';
+    _out[2] = __utf8_json_hex[(_code >> 12) & 0x0F];
+    _out[3] = __utf8_json_hex[(_code >> 8) & 0x0F];
+    _out[4] = __utf8_json_hex[(_code >> 4) & 0x0F];
+    _out[5] = __utf8_json_hex[_code & 0x0F];
+
+    return _out + 6;
+}
+//////////////////////////////////////////////////////////////////////////
+static size_t __utf8_json_escape( const char * _utf8, const char * _utf8End, uint32_t _flags, char * const _out, size_t _outCapacity )
+{
+    size_t outSize = 0;
+
+    for( const char * p = _utf8; p != _utf8End; )
+    {
+        size_t clean = __utf8_json_clean_run( p, _utf8End, _flags );
+
+        if( clean != 0 )
+        {
+            if( _out != NULL )
+            {
+                if( outSize + clean > _outCapacity )
+                {
+                    return UTF8_UNKNOWN;
+                }
+
+                memcpy( _out + outSize, p, clean );
+            }
+
+            outSize += clean;
+            p += clean;
+
+            if( p == _utf8End )
+            {
+                break;
+            }
+        }
+
+        char escape[12];
+        size_t escapeSize;
+
+        uint8_t c = (uint8_t)*p;
+
+        if( c < 0x80 )
+        {
+            escape[0] = '\\';
+            escapeSize = 2;
+
+            switch( c )
+            {
+            case '"': escape[1] = '"'; break;
+            case '\\': escape[1] = '\\'; break;
+            case '\b': escape[1] = 'b'; break;
+            case '\f': escape[1] = 'f'; break;
+            case '\n': escape[1] = 'n'; break;
+            case '\r': escape[1] = 'r'; break;
+            case '\t': escape[1] = 't'; break;
+            default:
+                escapeSize = (size_t)(__utf8_json_append_u16( escape, c ) - escape);
+                break;
+            }
+
+            ++p;
+        }
+        else
+        {
+            uint32_t code;
+            const char * next = utf8_next_code( p, _utf8End, &code );
+
+            if( next == NULL )
+            {
+                return UTF8_UNKNOWN;
+            }
+
+            if( (_flags & UTF8_JSON_ESCAPE_ASCII) == 0 )
+            {
+                escapeSize = (size_t)(next - p);
+                memcpy( escape, p, escapeSize );
+            }
+            else if( code < 0x10000 )
+            {
+                escapeSize = (size_t)(__utf8_json_append_u16( escape, code ) - escape);
+            }
+            else
+            {
+                uint32_t v = code - 0x10000;
+
+                char * e = __utf8_json_append_u16( escape, UTF8_SURROGATE_LO + (v >> 10) );
+                e = __utf8_json_append_u16( e, 0xDC00 + (v & 0x3FF) );
+
+                escapeSize = (size_t)(e - escape);
+            }
+
+            p = next;
+        }
+
+        if( _out != NULL )
+        {
+            if( outSize + escapeSize > _outCapacity )
+            {
+                return UTF8_UNKNOWN;
+            }
+
+            memcpy( _out + outSize, escape, escapeSize );
+        }
+
+        outSize += escapeSize;
+    }
+
+    return outSize;
+}
+//////////////////////////////////////////////////////////////////////////
+size_t utf8_json_escape_size( const char * _utf8, const char * _utf8End, uint32_t _flags )
+{
+    return __utf8_json_escape( _utf8, _utf8End, _flags, NULL, 0 );
+}
+//////////////////////////////////////////////////////////////////////////
+size_t utf8_json_escape( const char * _utf8, const char * _utf8End, uint32_t _flags, char * const _out, size_t _outCapacity )
+{
+    if( _out == NULL )
+    {
+        return UTF8_UNKNOWN;
+    }
+
+    return __utf8_json_escape( _utf8, _utf8End, _flags, _out, _outCapacity );
+}
+//////////////////////////////////////////////////////////////////////////
+static const char * __utf8_json_parse_u16( const char * _json, const char * _jsonEnd, uint32_t * const _code )
+{
+    if( _jsonEnd - _json < 6 || _json[0] != '\\' || _json[1] != 'u' )
+    {
+        return NULL;
+    }
+
+    uint32_t code = 0;
+
+    for( const char * p = _json + 2; p != _json + 6; ++p )
+    {
+        char c = *p;
+
+        uint32_t digit;
+
+        if( c >= '0' && c <= '9' )
+        {
+            digit = (uint32_t)(c - '0');
+        }
+        else if( c >= 'a' && c <= 'f' )
+        {
+            digit = (uint32_t)(c - 'a' + 10);
+        }
+        else if( c >= 'A' && c <= 'F' )
+        {
+            digit = (uint32_t)(c - 'A' + 10);
+        }
+        else
+        {
+            return NULL;
+        }
+
+        code = (code << 4) | digit;
+    }
+
+    *_code = code;
+
+    return _json + 6;
+}
+//////////////////////////////////////////////////////////////////////////
+size_t utf8_json_unescape( const char * _json, const char * _jsonEnd, char * const _out, size_t _outCapacity )
+{
+    if( _out == NULL )
+    {
+        return UTF8_UNKNOWN;
+    }
+
+    size_t outSize = 0;
+
+    for( const char * p = _json; p != _jsonEnd; )
+    {
+        size_t clean = __utf8_json_clean_run( p, _jsonEnd, UTF8_JSON_ESCAPE_DEFAULT );
+
+        if( clean != 0 )
+        {
+            if( outSize + clean > _outCapacity )
+            {
+                return UTF8_UNKNOWN;
+            }
+
+            memcpy( _out + outSize, p, clean );
+
+            outSize += clean;
+            p += clean;
+
+            if( p == _jsonEnd )
+            {
+                break;
+            }
+        }
+
+        char symbol[5];
+        size_t symbolSize;
+
+        uint8_t c = (uint8_t)*p;
+
+        if( c >= 0x80 )
+        {
+            const char * next = utf8_next_code( p, _jsonEnd, NULL );
+
+            if( next == NULL )
+            {
+                return UTF8_UNKNOWN;
+            }
+
+            symbolSize = (size_t)(next - p);
+            memcpy( symbol, p, symbolSize );
+
+            p = next;
+        }
+        else if( c == '\\' && _jsonEnd - p >= 2 )
+        {
+            const char * next = p + 2;
+
+            symbolSize = 1;
+
+            switch( p[1] )
+            {
+            case '"': symbol[0] = '"'; break;
+            case '\\': symbol[0] = '\\'; break;
+            case '/': symbol[0] = '/'; break;
+            case 'b': symbol[0] = '\b'; break;
+            case 'f': symbol[0] = '\f'; break;
+            case 'n': symbol[0] = '\n'; break;
+            case 'r': symbol[0] = '\r'; break;
+            case 't': symbol[0] = '\t'; break;
+            case 'u':
+                {
+                    uint32_t code;
+                    next = __utf8_json_parse_u16( p, _jsonEnd, &code );
+
+                    if( next == NULL )
+                    {
+                        return UTF8_UNKNOWN;
+                    }
+
+                    if( code >= 0xDC00 && code <= UTF8_SURROGATE_HI )
+                    {
+                        return UTF8_UNKNOWN;
+                    }
+
+                    if( code >= UTF8_SURROGATE_LO && code < 0xDC00 )
+                    {
+                        uint32_t low;
+                        next = __utf8_json_parse_u16( next, _jsonEnd, &low );
+
+                        if( next == NULL || low < 0xDC00 || low > UTF8_SURROGATE_HI )
+                        {
+                            return UTF8_UNKNOWN;
+                        }
+
+                        code = 0x10000 + ((code - UTF8_SURROGATE_LO) << 10) + (low - 0xDC00);
+                    }
+
+                    symbolSize = utf8_from_unicode32_symbol( code, symbol );
+                }
+                break;
+            default:
+                return UTF8_UNKNOWN;
+            }
+
+            p = next;
+        }
+        else
+        {
+            // unescaped quote, control character or dangling backslash
+            return UTF8_UNKNOWN;
+        }
+
+        if( outSize + symbolSize > _outCapacity )
+        {
+            return UTF8_UNKNOWN;
+        }
+
+        memcpy( _out + outSize, symbol, symbolSize );
+
+        outSize += symbolSize;
+    }
+
+    return outSize;
+}
+//////////////////////////////////////////////////////////////////////////
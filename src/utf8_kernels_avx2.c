@@ -0,0 +1,55 @@
+#include "utf8_internal.h"
+
+// built with AVX2 code generation (see CMakeLists.txt); only called after
+// the dispatcher has checked the CPU
+#include <immintrin.h>
+
+//////////////////////////////////////////////////////////////////////////
+static size_t __utf8_ascii_prefix_avx2( const char * _utf8, const char * _utf8End )
+{
+    const char * p = _utf8;
+
+    for( ; _utf8End - p >= 32; p += 32 )
+    {
+        __m256i v = _mm256_loadu_si256( (const __m256i *)p );
+
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8( v );
+
+        if( mask != 0 )
+        {
+            return (size_t)(p - _utf8) + __utf8_ctz32( mask );
+        }
+    }
+
+    return (size_t)(p - _utf8) + __utf8_ascii_prefix_scalar( p, _utf8End );
+}
+//////////////////////////////////////////////////////////////////////////
+static size_t __utf8_printable_ascii_prefix_avx2( const char * _utf8, const char * _utf8End )
+{
+    const char * p = _utf8;
+
+    const __m256i lo = _mm256_set1_epi8( 0x1F );
+    const __m256i hi = _mm256_set1_epi8( 0x7F );
+
+    for( ; _utf8End - p >= 32; p += 32 )
+    {
+        __m256i v = _mm256_loadu_si256( (const __m256i *)p );
+        __m256i ok = _mm256_and_si256( _mm256_cmpgt_epi8( v, lo ), _mm256_cmpgt_epi8( hi, v ) );
+
+        uint32_t mask = ~(uint32_t)_mm256_movemask_epi8( ok );
+
+        if( mask != 0 )
+        {
+            return (size_t)(p - _utf8) + __utf8_ctz32( mask );
+        }
+    }
+
+    return (size_t)(p - _utf8) + __utf8_printable_ascii_prefix_scalar( p, _utf8End );
+}
+//////////////////////////////////////////////////////////////////////////
+const utf8_kernels_t __utf8_kernels_avx2 = {
+    UTF8_ISA_AVX2,
+    &__utf8_ascii_prefix_avx2,
+    &__utf8_printable_ascii_prefix_avx2
+};
+//////////////////////////////////////////////////////////////////////////
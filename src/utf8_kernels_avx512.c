@@ -0,0 +1,69 @@
+#include "utf8_internal.h"
+
+// built with AVX-512 F/BW code generation (see CMakeLists.txt); only called
+// after the dispatcher has checked the CPU
+#include <immintrin.h>
+
+//////////////////////////////////////////////////////////////////////////
+static __m512i __utf8_load_avx512( const char * _utf8, const char * _utf8End, __mmask64 * const _valid )
+{
+    size_t available = (size_t)(_utf8End - _utf8);
+
+    if( available >= 64 )
+    {
+        *_valid = ~(__mmask64)0;
+
+        return _mm512_loadu_si512( (const void *)_utf8 );
+    }
+
+    // masked load: the tail needs no scalar loop and never reads past the end
+    *_valid = ((__mmask64)1 << available) - 1;
+
+    return _mm512_maskz_loadu_epi8( *_valid, (const void *)_utf8 );
+}
+//////////////////////////////////////////////////////////////////////////
+static size_t __utf8_ascii_prefix_avx512( const char * _utf8, const char * _utf8End )
+{
+    for( const char * p = _utf8; p < _utf8End; p += 64 )
+    {
+        __mmask64 valid;
+        __m512i v = __utf8_load_avx512( p, _utf8End, &valid );
+
+        uint64_t mask = (uint64_t)_mm512_movepi8_mask( v );
+
+        if( mask != 0 )
+        {
+            return (size_t)(p - _utf8) + __utf8_ctz64( mask );
+        }
+    }
+
+    return (size_t)(_utf8End - _utf8);
+}
+//////////////////////////////////////////////////////////////////////////
+static size_t __utf8_printable_ascii_prefix_avx512( const char * _utf8, const char * _utf8End )
+{
+    const __m512i lo = _mm512_set1_epi8( 0x1F );
+    const __m512i hi = _mm512_set1_epi8( 0x7F );
+
+    for( const char * p = _utf8; p < _utf8End; p += 64 )
+    {
+        __mmask64 valid;
+        __m512i v = __utf8_load_avx512( p, _utf8End, &valid );
+
+        uint64_t mask = (uint64_t)(~(_mm512_cmpgt_epi8_mask( v, lo ) & _mm512_cmplt_epi8_mask( v, hi )) & valid);
+
+        if( mask != 0 )
+        {
+            return (size_t)(p - _utf8) + __utf8_ctz64( mask );
+        }
+    }
+
+    return (size_t)(_utf8End - _utf8);
+}
+//////////////////////////////////////////////////////////////////////////
+const utf8_kernels_t __utf8_kernels_avx512 = {
+    UTF8_ISA_AVX512,
+    &__utf8_ascii_prefix_avx512,
+    &__utf8_printable_ascii_prefix_avx512
+};
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,55 @@
+#include "utf8_internal.h"
+
+#ifdef UTF8_SSE2
+#   include <emmintrin.h>
+
+//////////////////////////////////////////////////////////////////////////
+static size_t __utf8_ascii_prefix_sse2( const char * _utf8, const char * _utf8End )
+{
+    const char * p = _utf8;
+
+    for( ; _utf8End - p >= 16; p += 16 )
+    {
+        __m128i v = _mm_loadu_si128( (const __m128i *)p );
+
+        uint32_t mask = (uint32_t)_mm_movemask_epi8( v );
+
+        if( mask != 0 )
+        {
+            return (size_t)(p - _utf8) + __utf8_ctz32( mask );
+        }
+    }
+
+    return (size_t)(p - _utf8) + __utf8_ascii_prefix_scalar( p, _utf8End );
+}
+//////////////////////////////////////////////////////////////////////////
+static size_t __utf8_printable_ascii_prefix_sse2( const char * _utf8, const char * _utf8End )
+{
+    const char * p = _utf8;
+
+    const __m128i lo = _mm_set1_epi8( 0x1F );
+    const __m128i hi = _mm_set1_epi8( 0x7F );
+
+    for( ; _utf8End - p >= 16; p += 16 )
+    {
+        __m128i v = _mm_loadu_si128( (const __m128i *)p );
+        __m128i ok = _mm_and_si128( _mm_cmpgt_epi8( v, lo ), _mm_cmplt_epi8( v, hi ) );
+
+        uint32_t mask = (uint32_t)_mm_movemask_epi8( ok ) ^ 0xFFFF;
+
+        if( mask != 0 )
+        {
+            return (size_t)(p - _utf8) + __utf8_ctz32( mask );
+        }
+    }
+
+    return (size_t)(p - _utf8) + __utf8_printable_ascii_prefix_scalar( p, _utf8End );
+}
+//////////////////////////////////////////////////////////////////////////
+const utf8_kernels_t __utf8_kernels_sse2 = {
+    UTF8_ISA_SSE2,
+    &__utf8_ascii_prefix_sse2,
+    &__utf8_printable_ascii_prefix_sse2
+};
+//////////////////////////////////////////////////////////////////////////
+#endif
@@ -0,0 +1,235 @@
+#include "utf8_internal.h"
+
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////
+#define UTF8_SANITIZE_SAFE (-1)
+//////////////////////////////////////////////////////////////////////////
+static int __utf8_sanitize_category( uint32_t _code )
+{
+    if( _code < 0x20 )
+    {
+        if( _code == '\t' )
+        {
+            return UTF8_SANITIZE_SAFE;
+        }
+
+        return _code == '\n' || _code == '\r' ? UTF8_SANITIZE_LINE_BREAK : UTF8_SANITIZE_CONTROL;
+    }
+
+    if( _code < 0x7F )
+    {
+        return UTF8_SANITIZE_SAFE;
+    }
+
+    if( _code <= 0x9F )
+    {
+        return UTF8_SANITIZE_CONTROL;
+    }
+
+    if( _code < 0x061C )
+    {
+        return UTF8_SANITIZE_SAFE;
+    }
+
+    if( _code == 0x061C || _code == 0x200E || _code == 0x200F || (_code >= 0x202A && _code <= 0x202E) || (_code >= 0x2066 && _code <= 0x2069) )
+    {
+        return UTF8_SANITIZE_BIDI;
+    }
+
+    if( _code == 0x2028 || _code == 0x2029 )
+    {
+        return UTF8_SANITIZE_LINE_BREAK;
+    }
+
+    if( (_code >= 0xFDD0 && _code <= 0xFDEF) || (_code & 0xFFFE) == 0xFFFE )
+    {
+        return UTF8_SANITIZE_NONCHARACTER;
+    }
+
+    return UTF8_SANITIZE_SAFE;
+}
+//////////////////////////////////////////////////////////////////////////
+static size_t __utf8_sanitize_escape( uint32_t _code, int _byte, char * const _out )
+{
+    static const char hex[] = "0123456789ABCDEF";
+
+    size_t digits;
+
+    if( _byte != 0 || _code < 0x80 )
+    {
+        _out[0] = '\\';
+        _out[1] = 'x';
+        digits = 2;
+    }
+    else if( _code <= 0xFFFF )
+    {
+        _out[0] = '\\';
+        _out[1] = 'u';
+        digits = 4;
+    }
+    else
+    {
+        _out[0] = '\\';
+        _out[1] = 'U';
+        digits = 8;
+    }
+
+    for( size_t index = 0; index != digits; ++index )
+    {
+        _out[2 + index] = hex[(_code >> (4 * (digits - 1 - index))) & 0x0F];
+    }
+
+    return 2 + digits;
+}
+//////////////////////////////////////////////////////////////////////////
+static int __utf8_sanitize_apply( utf8_writer_t * const _writer, utf8_sanitize_action_e _action, const char * _utf8, size_t _size, uint32_t _code, int _byte )
+{
+    switch( _action )
+    {
+    case UTF8_SANITIZE_KEEP:
+        return __utf8_writer_write( _writer, _utf8, _size );
+    case UTF8_SANITIZE_REPLACE:
+        return __utf8_writer_write( _writer, "\xEF\xBF\xBD", 3 );
+    case UTF8_SANITIZE_DROP:
+        return 1;
+    case UTF8_SANITIZE_ESCAPE:
+        {
+            char escape[10];
+            size_t escapeSize = __utf8_sanitize_escape( _code, _byte, escape );
+
+            return __utf8_writer_write( _writer, escape, escapeSize );
+        }
+    }
+
+    return 0;
+}
+//////////////////////////////////////////////////////////////////////////
+static size_t __utf8_sanitize( const char * _utf8, const char * _utf8End, const utf8_sanitize_t * _config, char * const _out, size_t _outCapacity )
+{
+    utf8_writer_t writer;
+    writer.out = _out;
+    writer.capacity = _outCapacity;
+    writer.size = 0;
+
+    // once anything is escaped, a literal backslash must be too, or the
+    // text "\x41" could not be told apart from an escaped byte
+    int escapeBackslash = 0;
+
+    for( size_t index = 0; index != __UTF8_SANITIZE_CATEGORY_COUNT__; ++index )
+    {
+        if( _config->actions[index] == UTF8_SANITIZE_ESCAPE )
+        {
+            escapeBackslash = 1;
+        }
+    }
+
+    const char * p = _utf8;
+    const char * run = _utf8;
+
+    while( p != _utf8End )
+    {
+        // printable ASCII is safe in every category; extend the pending run
+        size_t printable = __utf8_printable_ascii_prefix( p, _utf8End );
+
+        if( escapeBackslash == 1 && printable != 0 )
+        {
+            const char * backslash = (const char *)memchr( p, '\\', printable );
+
+            if( backslash != NULL )
+            {
+                printable = (size_t)(backslash - p);
+            }
+        }
+
+        p += printable;
+
+        if( p == _utf8End )
+        {
+            break;
+        }
+
+        if( escapeBackslash == 1 && *p == '\\' )
+        {
+            if( __utf8_writer_write( &writer, run, (size_t)(p - run) ) == 0 || __utf8_writer_write( &writer, "\\\\", 2 ) == 0 )
+            {
+                return UTF8_UNKNOWN;
+            }
+
+            ++p;
+            run = p;
+
+            continue;
+        }
+
+        uint32_t code;
+        const char * next = utf8_next_code( p, _utf8End, &code );
+
+        int category;
+        size_t size;
+
+        if( next == NULL )
+        {
+            // one action per invalid byte, as utf8_replace_invalid() does
+            category = UTF8_SANITIZE_INVALID;
+            code = (uint8_t)*p;
+            size = 1;
+        }
+        else
+        {
+            category = __utf8_sanitize_category( code );
+            size = (size_t)(next - p);
+        }
+
+        if( category == UTF8_SANITIZE_SAFE || _config->actions[category] == UTF8_SANITIZE_KEEP )
+        {
+            p += size;
+
+            continue;
+        }
+
+        if( __utf8_writer_write( &writer, run, (size_t)(p - run) ) == 0 )
+        {
+            return UTF8_UNKNOWN;
+        }
+
+        if( __utf8_sanitize_apply( &writer, _config->actions[category], p, size, code, category == UTF8_SANITIZE_INVALID ) == 0 )
+        {
+            return UTF8_UNKNOWN;
+        }
+
+        p += size;
+        run = p;
+    }
+
+    if( __utf8_writer_write( &writer, run, (size_t)(p - run) ) == 0 )
+    {
+        return UTF8_UNKNOWN;
+    }
+
+    return writer.size;
+}
+//////////////////////////////////////////////////////////////////////////
+void utf8_sanitize_init( utf8_sanitize_t * const _config, utf8_sanitize_action_e _action )
+{
+    for( size_t index = 0; index != __UTF8_SANITIZE_CATEGORY_COUNT__; ++index )
+    {
+        _config->actions[index] = _action;
+    }
+}
+//////////////////////////////////////////////////////////////////////////
+size_t utf8_sanitize_size( const char * _utf8, const char * _utf8End, const utf8_sanitize_t * _config )
+{
+    return __utf8_sanitize( _utf8, _utf8End, _config, NULL, UTF8_UNKNOWN );
+}
+//////////////////////////////////////////////////////////////////////////
+size_t utf8_sanitize( const char * _utf8, const char * _utf8End, const utf8_sanitize_t * _config, char * const _out, size_t _outCapacity )
+{
+    if( _outCapacity == 0 )
+    {
+        return 0;
+    }
+
+    return __utf8_sanitize( _utf8, _utf8End, _config, _out, _outCapacity );
+}
+//////////////////////////////////////////////////////////////////////////
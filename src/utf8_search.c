@@ -0,0 +1,420 @@
+#include "utf8_internal.h"
+
+#include <string.h>
+
+#ifdef UTF8_SSE2
+#   include <emmintrin.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+static int __utf8_is_continuation( uint8_t _code )
+{
+    return (_code & 0xC0) == 0x80;
+}
+//////////////////////////////////////////////////////////////////////////
+#define UTF8_FIND_VERIFY_BUDGET( Scanned ) ((size_t)(Scanned) * 4 + 1024)
+//////////////////////////////////////////////////////////////////////////
+static size_t __utf8_max_suffix( const uint8_t * _needle, size_t _needleSize, int _reverse, size_t * const _period )
+{
+    // maximal suffix of the needle under the byte order (or its reverse);
+    // starts at -1 so that the first comparison is against byte 0
+    size_t suffix = (size_t)-1;
+    size_t j = 0;
+    size_t k = 1;
+    size_t period = 1;
+
+    while( j + k < _needleSize )
+    {
+        uint8_t a = _needle[j + k];
+        uint8_t b = _needle[suffix + k];
+
+        if( _reverse == 0 ? a < b : a > b )
+        {
+            j += k;
+            k = 1;
+            period = j - suffix;
+        }
+        else if( a == b )
+        {
+            if( k != period )
+            {
+                ++k;
+            }
+            else
+            {
+                j += period;
+                k = 1;
+            }
+        }
+        else
+        {
+            suffix = j++;
+            k = 1;
+            period = 1;
+        }
+    }
+
+    *_period = period;
+
+    return suffix + 1;
+}
+//////////////////////////////////////////////////////////////////////////
+static const char * __utf8_find_two_way( const char * _utf8, const char * _utf8End, const char * _needle, size_t _needleSize )
+{
+    // Crochemore-Perrin two-way matching: linear in the haystack size for
+    // any needle, used once the filtered scan stops paying off
+    const uint8_t * hay = (const uint8_t *)_utf8;
+    const uint8_t * needle = (const uint8_t *)_needle;
+
+    size_t size = (size_t)(_utf8End - _utf8);
+
+    size_t period;
+    size_t periodReverse;
+    size_t split = __utf8_max_suffix( needle, _needleSize, 0, &period );
+    size_t splitReverse = __utf8_max_suffix( needle, _needleSize, 1, &periodReverse );
+
+    if( splitReverse > split )
+    {
+        split = splitReverse;
+        period = periodReverse;
+    }
+
+    if( memcmp( needle, needle + period, split ) == 0 )
+    {
+        // periodic needle: remember how much of the right half is known
+        size_t memory = 0;
+
+        for( size_t j = 0; j + _needleSize <= size; )
+        {
+            size_t i = split > memory ? split : memory;
+
+            while( i < _needleSize && needle[i] == hay[i + j] )
+            {
+                ++i;
+            }
+
+            if( i < _needleSize )
+            {
+                j += i - split + 1;
+                memory = 0;
+
+                continue;
+            }
+
+            i = split;
+
+            while( i > memory && needle[i - 1] == hay[i - 1 + j] )
+            {
+                --i;
+            }
+
+            if( i <= memory )
+            {
+                return _utf8 + j;
+            }
+
+            j += period;
+            memory = _needleSize - period;
+        }
+    }
+    else
+    {
+        size_t shift = (split > _needleSize - split ? split : _needleSize - split) + 1;
+
+        for( size_t j = 0; j + _needleSize <= size; )
+        {
+            size_t i = split;
+
+            while( i < _needleSize && needle[i] == hay[i + j] )
+            {
+                ++i;
+            }
+
+            if( i < _needleSize )
+            {
+                j += i - split + 1;
+
+                continue;
+            }
+
+            i = split;
+
+            while( i > 0 && needle[i - 1] == hay[i - 1 + j] )
+            {
+                --i;
+            }
+
+            if( i == 0 )
+            {
+                return _utf8 + j;
+            }
+
+            j += shift;
+        }
+    }
+
+    return NULL;
+}
+//////////////////////////////////////////////////////////////////////////
+static const char * __utf8_find_candidate( const char * _utf8, const char * _utf8End, const char * _needle, size_t _needleSize )
+{
+    const char * last = _utf8End - _needleSize;
+
+    const char * p = _utf8;
+
+    // bytes spent verifying candidates; repetitive haystacks make the
+    // filter pass almost everything, so past a budget proportional to the
+    // scanned length the rest of the search goes to the two-way matcher
+    size_t verified = 0;
+
+#ifdef UTF8_SSE2
+    if( _needleSize > 1 )
+    {
+        const __m128i first = _mm_set1_epi8( _needle[0] );
+        const __m128i final = _mm_set1_epi8( _needle[_needleSize - 1] );
+
+        for( ; last - p >= 16; p += 16 )
+        {
+            __m128i vf = _mm_loadu_si128( (const __m128i *)p );
+            __m128i vl = _mm_loadu_si128( (const __m128i *)(p + _needleSize - 1) );
+
+            uint32_t mask = (uint32_t)_mm_movemask_epi8( _mm_and_si128( _mm_cmpeq_epi8( vf, first ), _mm_cmpeq_epi8( vl, final ) ) );
+
+            while( mask != 0 )
+            {
+                uint32_t index = __utf8_ctz32( mask );
+
+                verified += _needleSize;
+
+                if( verified > UTF8_FIND_VERIFY_BUDGET( p - _utf8 ) )
+                {
+                    return __utf8_find_two_way( p + index, _utf8End, _needle, _needleSize );
+                }
+
+                if( memcmp( p + index + 1, _needle + 1, _needleSize - 2 ) == 0 )
+                {
+                    return p + index;
+                }
+
+                mask &= mask - 1;
+            }
+        }
+    }
+#endif
+
+    while( p <= last )
+    {
+        const char * hit = (const char *)memchr( p, _needle[0], (size_t)(last - p) + 1 );
+
+        if( hit == NULL )
+        {
+            return NULL;
+        }
+
+        verified += _needleSize;
+
+        if( verified > UTF8_FIND_VERIFY_BUDGET( hit - _utf8 ) )
+        {
+            return __utf8_find_two_way( hit, _utf8End, _needle, _needleSize );
+        }
+
+        if( memcmp( hit + 1, _needle + 1, _needleSize - 1 ) == 0 )
+        {
+            return hit;
+        }
+
+        p = hit + 1;
+    }
+
+    return NULL;
+}
+//////////////////////////////////////////////////////////////////////////
+const char * utf8_find( const char * _utf8, const char * _utf8End, const char * _needle, const char * _needleEnd )
+{
+    if( _utf8 == NULL || _needle == NULL )
+    {
+        return NULL;
+    }
+
+    if( __utf8_validate( _needle, _needleEnd, NULL ) != _needleEnd )
+    {
+        return NULL;
+    }
+
+    size_t needleSize = (size_t)(_needleEnd - _needle);
+
+    if( needleSize == 0 )
+    {
+        return _utf8;
+    }
+
+    // A valid needle starts with a lead byte, so every hit starts on a code
+    // point boundary; only the byte after the hit needs checking to reject
+    // matches that end inside a longer (malformed) sequence.
+    for( const char * p = _utf8; (size_t)(_utf8End - p) >= needleSize; )
+    {
+        const char * hit = __utf8_find_candidate( p, _utf8End, _needle, needleSize );
+
+        if( hit == NULL )
+        {
+            return NULL;
+        }
+
+        const char * hitEnd = hit + needleSize;
+
+        if( hitEnd == _utf8End || __utf8_is_continuation( (uint8_t)*hitEnd ) == 0 )
+        {
+            return hit;
+        }
+
+        p = hit + 1;
+    }
+
+    return NULL;
+}
+//////////////////////////////////////////////////////////////////////////
+size_t utf8_codeset_init( utf8_codeset_t * const _set, const uint32_t * _codes, size_t _count )
+{
+    memset( _set, 0, sizeof( utf8_codeset_t ) );
+
+    for( size_t index = 0; index != _count; ++index )
+    {
+        uint32_t code = _codes[index];
+
+        if( index != 0 && _codes[index - 1] >= code )
+        {
+            return UTF8_UNKNOWN;
+        }
+
+        char utf8[5];
+        if( utf8_from_unicode32_symbol( code, utf8 ) == UTF8_UNKNOWN )
+        {
+            return UTF8_UNKNOWN;
+        }
+
+        uint8_t lead = (uint8_t)utf8[0];
+
+        if( code < 0x80 )
+        {
+            _set->ascii[lead >> 5] |= 1U << (lead & 0x1F);
+        }
+        else
+        {
+            _set->leads[lead >> 5] |= 1U << (lead & 0x1F);
+        }
+    }
+
+    _set->codes = _codes;
+    _set->count = _count;
+
+    return _count;
+}
+//////////////////////////////////////////////////////////////////////////
+static int __utf8_codeset_contains( const utf8_codeset_t * _set, uint32_t _code )
+{
+    size_t lo = 0;
+    size_t hi = _set->count;
+
+    while( lo < hi )
+    {
+        size_t mid = (lo + hi) / 2;
+
+        uint32_t code = _set->codes[mid];
+
+        if( code == _code )
+        {
+            return 1;
+        }
+        else if( code < _code )
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return 0;
+}
+//////////////////////////////////////////////////////////////////////////
+const char * utf8_find_first_of( const char * _utf8, const char * _utf8End, const utf8_codeset_t * _set, uint32_t * const _utf8Code )
+{
+    if( _utf8 == NULL || _set == NULL )
+    {
+        return NULL;
+    }
+
+    int asciiEmpty = (_set->ascii[0] | _set->ascii[1] | _set->ascii[2] | _set->ascii[3]) == 0;
+
+    for( const char * p = _utf8; p != _utf8End; )
+    {
+        if( asciiEmpty == 1 )
+        {
+            p += __utf8_ascii_prefix( p, _utf8End );
+
+            if( p == _utf8End )
+            {
+                break;
+            }
+        }
+
+        uint8_t c = (uint8_t)*p;
+
+        if( c < 0x80 )
+        {
+            if( _set->ascii[c >> 5] & (1U << (c & 0x1F)) )
+            {
+                if( _utf8Code != NULL )
+                {
+                    *_utf8Code = c;
+                }
+
+                return p;
+            }
+
+            ++p;
+
+            continue;
+        }
+
+        if( (_set->leads[c >> 5] & (1U << (c & 0x1F))) == 0 )
+        {
+            // no member starts with this lead byte: skip the sequence
+            // without decoding it
+            ++p;
+
+            while( p != _utf8End && __utf8_is_continuation( (uint8_t)*p ) )
+            {
+                ++p;
+            }
+
+            continue;
+        }
+
+        uint32_t code;
+        const char * next = utf8_next_code( p, _utf8End, &code );
+
+        if( next == NULL )
+        {
+            ++p;
+
+            continue;
+        }
+
+        if( __utf8_codeset_contains( _set, code ) == 1 )
+        {
+            if( _utf8Code != NULL )
+            {
+                *_utf8Code = code;
+            }
+
+            return p;
+        }
+
+        p = next;
+    }
+
+    return NULL;
+}
+//////////////////////////////////////////////////////////////////////////
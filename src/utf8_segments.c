@@ -0,0 +1,182 @@
+#include "utf8_internal.h"
+
+//////////////////////////////////////////////////////////////////////////
+typedef struct utf8_segment_cursor_t
+{
+    const utf8_span_t * segment;
+    const utf8_span_t * segmentEnd;
+    size_t offset;
+    size_t position;
+} utf8_segment_cursor_t;
+//////////////////////////////////////////////////////////////////////////
+static void __utf8_segment_skip_empty( utf8_segment_cursor_t * const _cursor )
+{
+    while( _cursor->segment != _cursor->segmentEnd && _cursor->offset == _cursor->segment->size )
+    {
+        ++_cursor->segment;
+        _cursor->offset = 0;
+    }
+}
+//////////////////////////////////////////////////////////////////////////
+static void __utf8_segment_advance( utf8_segment_cursor_t * const _cursor, size_t _bytes )
+{
+    _cursor->position += _bytes;
+
+    while( _bytes != 0 )
+    {
+        size_t available = _cursor->segment->size - _cursor->offset;
+
+        if( _bytes < available )
+        {
+            _cursor->offset += _bytes;
+
+            return;
+        }
+
+        _bytes -= available;
+
+        ++_cursor->segment;
+        _cursor->offset = 0;
+    }
+}
+//////////////////////////////////////////////////////////////////////////
+static const char * __utf8_segment_gather( const utf8_segment_cursor_t * _cursor, char * const _buffer, size_t _capacity )
+{
+    // copy the few bytes of a sequence that straddles segment boundaries
+    size_t size = 0;
+
+    const utf8_span_t * segment = _cursor->segment;
+    size_t offset = _cursor->offset;
+
+    while( size != _capacity && segment != _cursor->segmentEnd )
+    {
+        if( offset == segment->size )
+        {
+            ++segment;
+            offset = 0;
+
+            continue;
+        }
+
+        _buffer[size++] = segment->data[offset++];
+    }
+
+    return _buffer + size;
+}
+//////////////////////////////////////////////////////////////////////////
+static size_t __utf8_segments_decode( const utf8_span_t * _segments, size_t _count, wchar_t * const _unicode, size_t _unicodeCapacity, size_t * const _errorOffset )
+{
+    utf8_segment_cursor_t cursor;
+    cursor.segment = _segments;
+    cursor.segmentEnd = _segments + _count;
+    cursor.offset = 0;
+    cursor.position = 0;
+
+    size_t unicodeSize = 0;
+
+    for( ;; )
+    {
+        __utf8_segment_skip_empty( &cursor );
+
+        if( cursor.segment == cursor.segmentEnd || unicodeSize == _unicodeCapacity )
+        {
+            break;
+        }
+
+        const char * p = cursor.segment->data + cursor.offset;
+        const char * p_end = cursor.segment->data + cursor.segment->size;
+
+        size_t ascii = __utf8_ascii_prefix( p, p_end );
+
+        if( ascii > _unicodeCapacity - unicodeSize )
+        {
+            ascii = _unicodeCapacity - unicodeSize;
+        }
+
+        if( ascii != 0 )
+        {
+            if( _unicode != NULL )
+            {
+                for( size_t index = 0; index != ascii; ++index )
+                {
+                    _unicode[unicodeSize + index] = (wchar_t)(uint8_t)p[index];
+                }
+            }
+
+            unicodeSize += ascii;
+
+            __utf8_segment_advance( &cursor, ascii );
+
+            continue;
+        }
+
+        uint32_t code;
+        const char * next = utf8_next_code( p, p_end, &code );
+
+        size_t codeSize;
+
+        if( next != NULL )
+        {
+            codeSize = (size_t)(next - p);
+        }
+        else
+        {
+            char buffer[4];
+            const char * bufferEnd = __utf8_segment_gather( &cursor, buffer, 4 );
+
+            next = utf8_next_code( buffer, bufferEnd, &code );
+
+            if( next == NULL )
+            {
+                if( _errorOffset != NULL )
+                {
+                    *_errorOffset = cursor.position;
+                }
+
+                return UTF8_UNKNOWN;
+            }
+
+            codeSize = (size_t)(next - buffer);
+        }
+
+        if( _unicode != NULL )
+        {
+            _unicode[unicodeSize] = (wchar_t)code;
+        }
+
+        ++unicodeSize;
+
+        __utf8_segment_advance( &cursor, codeSize );
+    }
+
+    if( _errorOffset != NULL )
+    {
+        *_errorOffset = cursor.position;
+    }
+
+    return unicodeSize;
+}
+//////////////////////////////////////////////////////////////////////////
+size_t utf8_validate_segments( const utf8_span_t * _segments, size_t _count )
+{
+    size_t offset;
+    __utf8_segments_decode( _segments, _count, NULL, UTF8_UNKNOWN, &offset );
+
+    return offset;
+}
+//////////////////////////////////////////////////////////////////////////
+size_t utf8_to_unicode_segments_size( const utf8_span_t * _segments, size_t _count )
+{
+    return __utf8_segments_decode( _segments, _count, NULL, UTF8_UNKNOWN, NULL );
+}
+//////////////////////////////////////////////////////////////////////////
+size_t utf8_to_unicode_segments( const utf8_span_t * _segments, size_t _count, wchar_t * const _unicode, size_t _unicodeCapacity )
+{
+    if( _unicodeCapacity == 0 )
+    {
+        return 0;
+    }
+
+    return __utf8_segments_decode( _segments, _count, _unicode, _unicodeCapacity, NULL );
+}
+//////////////////////////////////////////////////////////////////////////
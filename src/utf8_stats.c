@@ -0,0 +1,223 @@
+#include "utf8_internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#   include <intrin.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+#if defined(_MSC_VER)
+#   define UTF8_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__)
+#   define UTF8_THREAD_LOCAL __thread
+#else
+#   define UTF8_THREAD_LOCAL _Thread_local
+#endif
+//////////////////////////////////////////////////////////////////////////
+// one block per thread, linked into a list that is only ever pushed to;
+// blocks outlive their threads so their counts stay in the totals
+typedef struct utf8_stats_block_t
+{
+    utf8_stats_t stats;
+    struct utf8_stats_block_t * next;
+} utf8_stats_block_t;
+//////////////////////////////////////////////////////////////////////////
+static utf8_stats_block_t * __utf8_stats_blocks = NULL;
+static UTF8_THREAD_LOCAL utf8_stats_block_t * __utf8_stats_block = NULL;
+//////////////////////////////////////////////////////////////////////////
+static const utf8_stats_hooks_t * __utf8_stats_hooks = NULL;
+//////////////////////////////////////////////////////////////////////////
+static utf8_stats_block_t * __utf8_stats_blocks_load( void )
+{
+#if defined(_MSC_VER)
+    return (utf8_stats_block_t *)_InterlockedCompareExchangePointer( (void * volatile *)&__utf8_stats_blocks, NULL, NULL );
+#else
+    return __atomic_load_n( &__utf8_stats_blocks, __ATOMIC_ACQUIRE );
+#endif
+}
+//////////////////////////////////////////////////////////////////////////
+static void __utf8_stats_blocks_push( utf8_stats_block_t * _block )
+{
+#if defined(_MSC_VER)
+    for( ;; )
+    {
+        utf8_stats_block_t * head = __utf8_stats_blocks_load();
+
+        _block->next = head;
+
+        if( _InterlockedCompareExchangePointer( (void * volatile *)&__utf8_stats_blocks, (void *)_block, (void *)head ) == (void *)head )
+        {
+            break;
+        }
+    }
+#else
+    utf8_stats_block_t * head = __utf8_stats_blocks_load();
+
+    do
+    {
+        _block->next = head;
+    }
+    while( __atomic_compare_exchange_n( &__utf8_stats_blocks, &head, _block, 1, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE ) == 0 );
+#endif
+}
+//////////////////////////////////////////////////////////////////////////
+static utf8_stats_block_t * __utf8_stats_thread_block( void )
+{
+    utf8_stats_block_t * block = __utf8_stats_block;
+
+    if( block != NULL )
+    {
+        return block;
+    }
+
+    block = (utf8_stats_block_t *)calloc( 1, sizeof( utf8_stats_block_t ) );
+
+    if( block == NULL )
+    {
+        return NULL;
+    }
+
+    __utf8_stats_blocks_push( block );
+
+    __utf8_stats_block = block;
+
+    return block;
+}
+//////////////////////////////////////////////////////////////////////////
+// utf8_stats_counters_t is all uint64_t; walk it as an array
+#define UTF8_STATS_COUNTER_COUNT (sizeof( utf8_stats_t ) / sizeof( uint64_t ))
+//////////////////////////////////////////////////////////////////////////
+static uint64_t __utf8_stats_counter_load( uint64_t * _counter )
+{
+#if defined(_MSC_VER)
+    return (uint64_t)_InterlockedCompareExchange64( (__int64 volatile *)_counter, 0, 0 );
+#else
+    return __atomic_load_n( _counter, __ATOMIC_RELAXED );
+#endif
+}
+//////////////////////////////////////////////////////////////////////////
+static void __utf8_stats_counter_add( uint64_t * _counter, uint64_t _value )
+{
+    // the owner adds while utf8_stats_reset() may clear from another thread
+#if defined(_MSC_VER)
+    _InterlockedExchangeAdd64( (__int64 volatile *)_counter, (__int64)_value );
+#else
+    __atomic_fetch_add( _counter, _value, __ATOMIC_RELAXED );
+#endif
+}
+//////////////////////////////////////////////////////////////////////////
+static void __utf8_stats_counter_clear( uint64_t * _counter )
+{
+#if defined(_MSC_VER)
+    _InterlockedExchange64( (__int64 volatile *)_counter, 0 );
+#else
+    __atomic_exchange_n( _counter, 0, __ATOMIC_RELAXED );
+#endif
+}
+//////////////////////////////////////////////////////////////////////////
+static const utf8_stats_hooks_t * __utf8_stats_hooks_load( void )
+{
+#if defined(_MSC_VER)
+    return (const utf8_stats_hooks_t *)_InterlockedCompareExchangePointer( (void * volatile *)&__utf8_stats_hooks, NULL, NULL );
+#else
+    return __atomic_load_n( &__utf8_stats_hooks, __ATOMIC_ACQUIRE );
+#endif
+}
+//////////////////////////////////////////////////////////////////////////
+const utf8_stats_hooks_t * __utf8_stats_begin( utf8_stats_function_e _function )
+{
+    const utf8_stats_hooks_t * hooks = __utf8_stats_hooks_load();
+
+    if( hooks != NULL && hooks->begin != NULL )
+    {
+        (*hooks->begin)( _function, hooks->ud );
+    }
+
+    return hooks;
+}
+//////////////////////////////////////////////////////////////////////////
+void __utf8_stats_record( const utf8_stats_hooks_t * _hooks, utf8_stats_function_e _function, const char * _utf8, const char * _utf8End, size_t _asciiBytes, utf8_stats_path_e _path, int _error )
+{
+    size_t bytes = (size_t)(_utf8End - _utf8);
+
+    utf8_stats_block_t * block = __utf8_stats_thread_block();
+
+    if( block != NULL )
+    {
+        utf8_stats_counters_t * counters = block->stats.functions + _function;
+
+        __utf8_stats_counter_add( &counters->calls, 1 );
+        __utf8_stats_counter_add( &counters->bytes, bytes );
+        __utf8_stats_counter_add( &counters->ascii_bytes, _asciiBytes );
+        __utf8_stats_counter_add( counters->paths + _path, 1 );
+
+        if( _error != 0 )
+        {
+            __utf8_stats_counter_add( &counters->errors, 1 );
+        }
+
+        if( _asciiBytes == bytes )
+        {
+            __utf8_stats_counter_add( &counters->ascii_calls, 1 );
+        }
+    }
+
+    // the hooks seen by the begin call, so begin and end always pair up
+    if( _hooks != NULL && _hooks->end != NULL )
+    {
+        (*_hooks->end)( _function, bytes, _asciiBytes, _error, _hooks->ud );
+    }
+}
+//////////////////////////////////////////////////////////////////////////
+void utf8_stats_get( utf8_stats_t * const _stats )
+{
+    uint64_t * total = (uint64_t *)_stats;
+
+    memset( _stats, 0, sizeof( utf8_stats_t ) );
+
+    for( utf8_stats_block_t * block = __utf8_stats_blocks_load(); block != NULL; block = block->next )
+    {
+        uint64_t * counters = (uint64_t *)&block->stats;
+
+        for( size_t index = 0; index != UTF8_STATS_COUNTER_COUNT; ++index )
+        {
+            total[index] += __utf8_stats_counter_load( counters + index );
+        }
+    }
+}
+//////////////////////////////////////////////////////////////////////////
+void utf8_stats_reset( void )
+{
+    for( utf8_stats_block_t * block = __utf8_stats_blocks_load(); block != NULL; block = block->next )
+    {
+        uint64_t * counters = (uint64_t *)&block->stats;
+
+        for( size_t index = 0; index != UTF8_STATS_COUNTER_COUNT; ++index )
+        {
+            __utf8_stats_counter_clear( counters + index );
+        }
+    }
+}
+//////////////////////////////////////////////////////////////////////////
+void utf8_stats_accumulate( utf8_stats_t * const _total, const utf8_stats_t * _stats )
+{
+    uint64_t * total = (uint64_t *)_total;
+    const uint64_t * stats = (const uint64_t *)_stats;
+
+    for( size_t index = 0; index != UTF8_STATS_COUNTER_COUNT; ++index )
+    {
+        total[index] += stats[index];
+    }
+}
+//////////////////////////////////////////////////////////////////////////
+void utf8_stats_set_hooks( const utf8_stats_hooks_t * _hooks )
+{
+#if defined(_MSC_VER)
+    _InterlockedExchangePointer( (void * volatile *)&__utf8_stats_hooks, (void *)_hooks );
+#else
+    __atomic_store_n( &__utf8_stats_hooks, _hooks, __ATOMIC_RELEASE );
+#endif
+}
+//////////////////////////////////////////////////////////////////////////
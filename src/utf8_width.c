@@ -0,0 +1,367 @@
+#include "utf8_internal.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Display width ranges, Unicode 14.0 (East_Asian_Width W/F are 2 columns;
+// nonspacing/enclosing marks, format and control characters and Hangul
+// medial/final jamo are 0 columns). Each entry is
+// (first_code_point << 2) | width and covers everything up to the next entry.
+//////////////////////////////////////////////////////////////////////////
+static const uint32_t __utf8_width_ranges[] = {
+    0x0000000, 0x0000081, 0x00001FC, 0x0000281, 0x0000C00, 0x0000DC1, 0x0000DE2, 0x0000DE9,
+    0x0000E02, 0x0000E11, 0x0000E2E, 0x0000E31, 0x0000E36, 0x0000E39, 0x0000E8A, 0x0000E8D,
+    0x000120C, 0x0001229, 0x00014C2, 0x00014C5, 0x000155E, 0x0001565, 0x000162E, 0x0001635,
+    0x0001642, 0x0001644, 0x00016F9, 0x00016FC, 0x0001701, 0x0001704, 0x000170D, 0x0001710,
+    0x0001719, 0x000171C, 0x0001722, 0x0001741, 0x00017AE, 0x00017BD, 0x00017D6, 0x0001800,
+    0x0001819, 0x0001840, 0x000186D, 0x0001870, 0x0001875, 0x000192C, 0x0001981, 0x00019C0,
+    0x00019C5, 0x0001B58, 0x0001B79, 0x0001B7C, 0x0001B95, 0x0001B9C, 0x0001BA5, 0x0001BA8,
+    0x0001BB9, 0x0001C3A, 0x0001C3C, 0x0001C41, 0x0001C44, 0x0001C49, 0x0001CC0, 0x0001D2E,
+    0x0001D35, 0x0001E98, 0x0001EC5, 0x0001ECA, 0x0001F01, 0x0001FAC, 0x0001FD1, 0x0001FEE,
+    0x0001FF4, 0x0001FF9, 0x0002058, 0x0002069, 0x000206C, 0x0002091, 0x0002094, 0x00020A1,
+    0x00020A4, 0x00020BA, 0x00020C1, 0x00020FE, 0x0002101, 0x0002164, 0x0002172, 0x0002179,
+    0x000217E, 0x0002181, 0x00021AE, 0x00021C1, 0x000223E, 0x0002240, 0x000224A, 0x0002260,
+    0x0002281, 0x0002328, 0x000240D, 0x00024E8, 0x00024ED, 0x00024F0, 0x00024F5, 0x0002504,
+    0x0002525, 0x0002534, 0x0002539, 0x0002544, 0x0002561, 0x0002588, 0x0002591, 0x0002604,
+    0x0002609, 0x0002612, 0x0002615, 0x0002636, 0x000263D, 0x0002646, 0x000264D, 0x00026A6,
+    0x00026A9, 0x00026C6, 0x00026C9, 0x00026CE, 0x00026D9, 0x00026EA, 0x00026F0, 0x00026F5,
+    0x0002704, 0x0002716, 0x000271D, 0x0002726, 0x000272D, 0x0002734, 0x0002739, 0x000273E,
+    0x000275D, 0x0002762, 0x0002771, 0x000277A, 0x000277D, 0x0002788, 0x0002792, 0x0002799,
+    0x00027F8, 0x00027FE, 0x0002804, 0x000280D, 0x0002812, 0x0002815, 0x000282E, 0x000283D,
+    0x0002846, 0x000284D, 0x00028A6, 0x00028A9, 0x00028C6, 0x00028C9, 0x00028D2, 0x00028D5,
+    0x00028DE, 0x00028E1, 0x00028EA, 0x00028F0, 0x00028F6, 0x00028F9, 0x0002904, 0x000290E,
+    0x000291C, 0x0002926, 0x000292C, 0x000293A, 0x0002944, 0x000294A, 0x0002965, 0x0002976,
+    0x0002979, 0x000297E, 0x0002999, 0x00029C0, 0x00029C9, 0x00029D4, 0x00029D9, 0x00029DE,
+    0x0002A04, 0x0002A0D, 0x0002A12, 0x0002A15, 0x0002A3A, 0x0002A3D, 0x0002A4A, 0x0002A4D,
+    0x0002AA6, 0x0002AA9, 0x0002AC6, 0x0002AC9, 0x0002AD2, 0x0002AD5, 0x0002AEA, 0x0002AF0,
+    0x0002AF5, 0x0002B04, 0x0002B1A, 0x0002B1C, 0x0002B25, 0x0002B2A, 0x0002B2D, 0x0002B34,
+    0x0002B3A, 0x0002B41, 0x0002B46, 0x0002B81, 0x0002B88, 0x0002B92, 0x0002B99, 0x0002BCA,
+    0x0002BE5, 0x0002BE8, 0x0002C02, 0x0002C04, 0x0002C09, 0x0002C12, 0x0002C15, 0x0002C36,
+    0x0002C3D, 0x0002C46, 0x0002C4D, 0x0002CA6, 0x0002CA9, 0x0002CC6, 0x0002CC9, 0x0002CD2,
+    0x0002CD5, 0x0002CEA, 0x0002CF0, 0x0002CF5, 0x0002CFC, 0x0002D01, 0x0002D04, 0x0002D16,
+    0x0002D1D, 0x0002D26, 0x0002D2D, 0x0002D34, 0x0002D3A, 0x0002D54, 0x0002D5D, 0x0002D62,
+    0x0002D71, 0x0002D7A, 0x0002D7D, 0x0002D88, 0x0002D92, 0x0002D99, 0x0002DE2, 0x0002E08,
+    0x0002E0D, 0x0002E12, 0x0002E15, 0x0002E2E, 0x0002E39, 0x0002E46, 0x0002E49, 0x0002E5A,
+    0x0002E65, 0x0002E6E, 0x0002E71, 0x0002E76, 0x0002E79, 0x0002E82, 0x0002E8D, 0x0002E96,
+    0x0002EA1, 0x0002EAE, 0x0002EB9, 0x0002EEA, 0x0002EF9, 0x0002F00, 0x0002F05, 0x0002F0E,
+    0x0002F19, 0x0002F26, 0x0002F29, 0x0002F34, 0x0002F3A, 0x0002F41, 0x0002F46, 0x0002F5D,
+    0x0002F62, 0x0002F99, 0x0002FEE, 0x0003000, 0x0003005, 0x0003010, 0x0003015, 0x0003036,
+    0x0003039, 0x0003046, 0x0003049, 0x00030A6, 0x00030A9, 0x00030EA, 0x00030F0, 0x00030F5,
+    0x00030F8, 0x0003105, 0x0003116, 0x0003118, 0x0003126, 0x0003128, 0x000313A, 0x0003154,
+    0x000315E, 0x0003161, 0x000316E, 0x0003175, 0x000317A, 0x0003181, 0x0003188, 0x0003192,
+    0x0003199, 0x00031C2, 0x00031DD, 0x0003204, 0x0003209, 0x0003236, 0x0003239, 0x0003246,
+    0x0003249, 0x00032A6, 0x00032A9, 0x00032D2, 0x00032D5, 0x00032EA, 0x00032F0, 0x00032F5,
+    0x00032FC, 0x0003301, 0x0003316, 0x0003318, 0x000331D, 0x0003326, 0x0003329, 0x0003330,
+    0x000333A, 0x0003355, 0x000335E, 0x0003375, 0x000337E, 0x0003381, 0x0003388, 0x0003392,
+    0x0003399, 0x00033C2, 0x00033C5, 0x00033CE, 0x0003400, 0x0003409, 0x0003436, 0x0003439,
+    0x0003446, 0x0003449, 0x00034EC, 0x00034F5, 0x0003504, 0x0003516, 0x0003519, 0x0003526,
+    0x0003529, 0x0003534, 0x0003539, 0x0003542, 0x0003551, 0x0003588, 0x0003592, 0x0003599,
+    0x0003602, 0x0003604, 0x0003609, 0x0003612, 0x0003615, 0x000365E, 0x0003669, 0x00036CA,
+    0x00036CD, 0x00036F2, 0x00036F5, 0x00036FA, 0x0003701, 0x000371E, 0x0003728, 0x000372E,
+    0x000373D, 0x0003748, 0x0003756, 0x0003758, 0x000375E, 0x0003761, 0x0003782, 0x0003799,
+    0x00037C2, 0x00037C9, 0x00037D6, 0x0003805, 0x00038C4, 0x00038C9, 0x00038D0, 0x00038EE,
+    0x00038FD, 0x000391C, 0x000393D, 0x0003972, 0x0003A05, 0x0003A0E, 0x0003A11, 0x0003A16,
+    0x0003A19, 0x0003A2E, 0x0003A31, 0x0003A92, 0x0003A95, 0x0003A9A, 0x0003A9D, 0x0003AC4,
+    0x0003AC9, 0x0003AD0, 0x0003AF5, 0x0003AFA, 0x0003B01, 0x0003B16, 0x0003B19, 0x0003B1E,
+    0x0003B20, 0x0003B3A, 0x0003B41, 0x0003B6A, 0x0003B71, 0x0003B82, 0x0003C01, 0x0003C60,
+    0x0003C69, 0x0003CD4, 0x0003CD9, 0x0003CDC, 0x0003CE1, 0x0003CE4, 0x0003CE9, 0x0003D22,
+    0x0003D25, 0x0003DB6, 0x0003DC4, 0x0003DFD, 0x0003E00, 0x0003E15, 0x0003E18, 0x0003E21,
+    0x0003E34, 0x0003E62, 0x0003E64, 0x0003EF6, 0x0003EF9, 0x0003F18, 0x0003F1D, 0x0003F36,
+    0x0003F39, 0x0003F6E, 0x0004001, 0x00040B4, 0x00040C5, 0x00040C8, 0x00040E1, 0x00040E4,
+    0x00040ED, 0x00040F4, 0x00040FD, 0x0004160, 0x0004169, 0x0004178, 0x0004185, 0x00041C4,
+    0x00041D5, 0x0004208, 0x000420D, 0x0004214, 0x000421D, 0x0004234, 0x0004239, 0x0004274,
+    0x0004279, 0x000431A, 0x000431D, 0x0004322, 0x0004335, 0x000433A, 0x0004341, 0x0004402,
+    0x0004580, 0x0004801, 0x0004926, 0x0004929, 0x000493A, 0x0004941, 0x000495E, 0x0004961,
+    0x0004966, 0x0004969, 0x000497A, 0x0004981, 0x0004A26, 0x0004A29, 0x0004A3A, 0x0004A41,
+    0x0004AC6, 0x0004AC9, 0x0004ADA, 0x0004AE1, 0x0004AFE, 0x0004B01, 0x0004B06, 0x0004B09,
+    0x0004B1A, 0x0004B21, 0x0004B5E, 0x0004B61, 0x0004C46, 0x0004C49, 0x0004C5A, 0x0004C61,
+    0x0004D6E, 0x0004D74, 0x0004D81, 0x0004DF6, 0x0004E01, 0x0004E6A, 0x0004E81, 0x0004FDA,
+    0x0004FE1, 0x0004FFA, 0x0005001, 0x0005A76, 0x0005A81, 0x0005BE6, 0x0005C01, 0x0005C48,
+    0x0005C55, 0x0005C5A, 0x0005C7D, 0x0005CC8, 0x0005CD1, 0x0005CDE, 0x0005D01, 0x0005D48,
+    0x0005D52, 0x0005D81, 0x0005DB6, 0x0005DB9, 0x0005DC6, 0x0005DC8, 0x0005DD2, 0x0005E01,
+    0x0005ED0, 0x0005ED9, 0x0005EDC, 0x0005EF9, 0x0005F18, 0x0005F1D, 0x0005F24, 0x0005F51,
+    0x0005F74, 0x0005F7A, 0x0005F81, 0x0005FAA, 0x0005FC1, 0x0005FEA, 0x0006001, 0x000602C,
+    0x0006041, 0x000606A, 0x0006081, 0x00061E6, 0x0006201, 0x0006214, 0x000621D, 0x00062A4,
+    0x00062A9, 0x00062AE, 0x00062C1, 0x00063DA, 0x0006401, 0x000647E, 0x0006480, 0x000648D,
+    0x000649C, 0x00064A5, 0x00064B2, 0x00064C1, 0x00064C8, 0x00064CD, 0x00064E4, 0x00064F2,
+    0x0006501, 0x0006506, 0x0006511, 0x00065BA, 0x00065C1, 0x00065D6, 0x0006601, 0x00066B2,
+    0x00066C1, 0x000672A, 0x0006741, 0x000676E, 0x0006779, 0x000685C, 0x0006865, 0x000686C,
+    0x0006872, 0x0006879, 0x0006958, 0x000695D, 0x0006960, 0x000697E, 0x0006980, 0x0006985,
+    0x0006988, 0x000698D, 0x0006994, 0x00069B5, 0x00069CC, 0x00069F6, 0x00069FC, 0x0006A01,
+    0x0006A2A, 0x0006A41, 0x0006A6A, 0x0006A81, 0x0006ABA, 0x0006AC0, 0x0006B3E, 0x0006C00,
+    0x0006C11, 0x0006CD0, 0x0006CD5, 0x0006CD8, 0x0006CED, 0x0006CF0, 0x0006CF5, 0x0006D08,
+    0x0006D0D, 0x0006D36, 0x0006D41, 0x0006DAC, 0x0006DD1, 0x0006DFE, 0x0006E00, 0x0006E09,
+    0x0006E88, 0x0006E99, 0x0006EA0, 0x0006EA9, 0x0006EAC, 0x0006EB9, 0x0006F98, 0x0006F9D,
+    0x0006FA0, 0x0006FA9, 0x0006FB4, 0x0006FB9, 0x0006FBC, 0x0006FC9, 0x0006FD2, 0x0006FF1,
+    0x00070B0, 0x00070D1, 0x00070D8, 0x00070E2, 0x00070ED, 0x000712A, 0x0007135, 0x0007226,
+    0x0007241, 0x00072EE, 0x00072F5, 0x0007322, 0x0007340, 0x000734D, 0x0007350, 0x0007385,
+    0x0007388, 0x00073A5, 0x00073B4, 0x00073B9, 0x00073D0, 0x00073D5, 0x00073E0, 0x00073E9,
+    0x00073EE, 0x0007401, 0x0007700, 0x0007801, 0x0007C5A, 0x0007C61, 0x0007C7A, 0x0007C81,
+    0x0007D1A, 0x0007D21, 0x0007D3A, 0x0007D41, 0x0007D62, 0x0007D65, 0x0007D6A, 0x0007D6D,
+    0x0007D72, 0x0007D75, 0x0007D7A, 0x0007D7D, 0x0007DFA, 0x0007E01, 0x0007ED6, 0x0007ED9,
+    0x0007F16, 0x0007F19, 0x0007F52, 0x0007F59, 0x0007F72, 0x0007F75, 0x0007FC2, 0x0007FC9,
+    0x0007FD6, 0x0007FD9, 0x0007FFE, 0x0008001, 0x000802C, 0x0008041, 0x00080A0, 0x00080BD,
+    0x0008180, 0x0008196, 0x0008198, 0x00081C1, 0x00081CA, 0x00081D1, 0x000823E, 0x0008241,
+    0x0008276, 0x0008281, 0x0008306, 0x0008340, 0x00083C6, 0x0008401, 0x0008632, 0x0008641,
+    0x0008C6A, 0x0008C71, 0x0008CA6, 0x0008CAD, 0x0008FA6, 0x0008FB5, 0x0008FC2, 0x0008FC5,
+    0x0008FCE, 0x0008FD1, 0x000909E, 0x0009101, 0x000912E, 0x0009181, 0x00097F6, 0x00097FD,
+    0x0009852, 0x0009859, 0x0009922, 0x0009951, 0x00099FE, 0x0009A01, 0x0009A4E, 0x0009A51,
+    0x0009A86, 0x0009A89, 0x0009AAA, 0x0009AB1, 0x0009AF6, 0x0009AFD, 0x0009B12, 0x0009B19,
+    0x0009B3A, 0x0009B3D, 0x0009B52, 0x0009B55, 0x0009BAA, 0x0009BAD, 0x0009BCA, 0x0009BD1,
+    0x0009BD6, 0x0009BD9, 0x0009BEA, 0x0009BED, 0x0009BF6, 0x0009BF9, 0x0009C16, 0x0009C19,
+    0x0009C2A, 0x0009C31, 0x0009CA2, 0x0009CA5, 0x0009D32, 0x0009D35, 0x0009D3A, 0x0009D3D,
+    0x0009D4E, 0x0009D59, 0x0009D5E, 0x0009D61, 0x0009E56, 0x0009E61, 0x0009EC2, 0x0009EC5,
+    0x0009EFE, 0x0009F01, 0x000AC6E, 0x000AC75, 0x000AD42, 0x000AD45, 0x000AD56, 0x000AD59,
+    0x000ADD2, 0x000ADD9, 0x000AE5A, 0x000AE5D, 0x000B3BC, 0x000B3C9, 0x000B3D2, 0x000B3E5,
+    0x000B49A, 0x000B49D, 0x000B4A2, 0x000B4B5, 0x000B4BA, 0x000B4C1, 0x000B5A2, 0x000B5BD,
+    0x000B5C6, 0x000B5FC, 0x000B601, 0x000B65E, 0x000B681, 0x000B69E, 0x000B6A1, 0x000B6BE,
+    0x000B6C1, 0x000B6DE, 0x000B6E1, 0x000B6FE, 0x000B701, 0x000B71E, 0x000B721, 0x000B73E,
+    0x000B741, 0x000B75E, 0x000B761, 0x000B77E, 0x000B780, 0x000B801, 0x000B97A, 0x000C0A8,
+    0x000C0BA, 0x000C0FD, 0x000C102, 0x000C264, 0x000C26E, 0x000C921, 0x000C942, 0x0013701,
+    0x0013802, 0x0029341, 0x00298B2, 0x0029901, 0x00299BC, 0x00299CD, 0x00299D0, 0x00299F9,
+    0x0029A78, 0x0029A81, 0x0029BC0, 0x0029BC9, 0x0029BE2, 0x0029C01, 0x0029F2E, 0x0029F41,
+    0x0029F4A, 0x0029F4D, 0x0029F52, 0x0029F55, 0x0029F6A, 0x0029FC9, 0x002A008, 0x002A00D,
+    0x002A018, 0x002A01D, 0x002A02C, 0x002A031, 0x002A094, 0x002A09D, 0x002A0B0, 0x002A0B6,
+    0x002A0C1, 0x002A0EA, 0x002A101, 0x002A1E2, 0x002A201, 0x002A310, 0x002A31A, 0x002A339,
+    0x002A36A, 0x002A380, 0x002A3C9, 0x002A3FC, 0x002A401, 0x002A498, 0x002A4B9, 0x002A51C,
+    0x002A549, 0x002A552, 0x002A57D, 0x002A582, 0x002A600, 0x002A60D, 0x002A6CC, 0x002A6D1,
+    0x002A6D8, 0x002A6E9, 0x002A6F0, 0x002A6F9, 0x002A73A, 0x002A73D, 0x002A76A, 0x002A779,
+    0x002A794, 0x002A799, 0x002A7FE, 0x002A801, 0x002A8A4, 0x002A8BD, 0x002A8C4, 0x002A8CD,
+    0x002A8D4, 0x002A8DE, 0x002A901, 0x002A90C, 0x002A911, 0x002A930, 0x002A935, 0x002A93A,
+    0x002A941, 0x002A96A, 0x002A971, 0x002A9F0, 0x002A9F5, 0x002AAC0, 0x002AAC5, 0x002AAC8,
+    0x002AAD5, 0x002AADC, 0x002AAE5, 0x002AAF8, 0x002AB01, 0x002AB04, 0x002AB09, 0x002AB0E,
+    0x002AB6D, 0x002ABB0, 0x002ABB9, 0x002ABD8, 0x002ABDE, 0x002AC05, 0x002AC1E, 0x002AC25,
+    0x002AC3E, 0x002AC45, 0x002AC5E, 0x002AC81, 0x002AC9E, 0x002ACA1, 0x002ACBE, 0x002ACC1,
+    0x002ADB2, 0x002ADC1, 0x002AF94, 0x002AF99, 0x002AFA0, 0x002AFA5, 0x002AFB4, 0x002AFBA,
+    0x002AFC1, 0x002AFEA, 0x0035EC0, 0x0036001, 0x003E402, 0x003EC01, 0x003EC1E, 0x003EC4D,
+    0x003EC62, 0x003EC75, 0x003EC78, 0x003EC7D, 0x003ECDE, 0x003ECE1, 0x003ECF6, 0x003ECF9,
+    0x003ECFE, 0x003ED01, 0x003ED0A, 0x003ED0D, 0x003ED16, 0x003ED19, 0x003EF0E, 0x003EF4D,
+    0x003F642, 0x003F649, 0x003F722, 0x003F73D, 0x003F742, 0x003F7C1, 0x003F800, 0x003F842,
+    0x003F880, 0x003F8C2, 0x003F9C1, 0x003F9D6, 0x003F9D9, 0x003FBF6, 0x003FBFC, 0x003FC02,
+    0x003FD85, 0x003FEFE, 0x003FF09, 0x003FF22, 0x003FF29, 0x003FF42, 0x003FF49, 0x003FF62,
+    0x003FF69, 0x003FF76, 0x003FFA1, 0x003FFBE, 0x003FFE4, 0x003FFF1, 0x003FFFA, 0x0040001,
+    0x0040032, 0x0040035, 0x004009E, 0x00400A1, 0x00400EE, 0x00400F1, 0x00400FA, 0x00400FD,
+    0x004013A, 0x0040141, 0x004017A, 0x0040201, 0x00403EE, 0x0040401, 0x004040E, 0x004041D,
+    0x00404D2, 0x00404DD, 0x004063E, 0x0040641, 0x0040676, 0x0040681, 0x0040686, 0x0040741,
+    0x00407F4, 0x00407FA, 0x0040A01, 0x0040A76, 0x0040A81, 0x0040B46, 0x0040B80, 0x0040B85,
+    0x0040BF2, 0x0040C01, 0x0040C92, 0x0040CB5, 0x0040D2E, 0x0040D41, 0x0040DD8, 0x0040DEE,
+    0x0040E01, 0x0040E7A, 0x0040E7D, 0x0040F12, 0x0040F21, 0x0040F5A, 0x0041001, 0x004127A,
+    0x0041281, 0x00412AA, 0x00412C1, 0x0041352, 0x0041361, 0x00413F2, 0x0041401, 0x00414A2,
+    0x00414C1, 0x0041592, 0x00415BD, 0x00415EE, 0x00415F1, 0x004162E, 0x0041631, 0x004164E,
+    0x0041651, 0x004165A, 0x004165D, 0x004168A, 0x004168D, 0x00416CA, 0x00416CD, 0x00416EA,
+    0x00416ED, 0x00416F6, 0x0041801, 0x0041CDE, 0x0041D01, 0x0041D5A, 0x0041D81, 0x0041DA2,
+    0x0041E01, 0x0041E1A, 0x0041E1D, 0x0041EC6, 0x0041EC9, 0x0041EEE, 0x0042001, 0x004201A,
+    0x0042021, 0x0042026, 0x0042029, 0x00420DA, 0x00420DD, 0x00420E6, 0x00420F1, 0x00420F6,
+    0x00420FD, 0x004215A, 0x004215D, 0x004227E, 0x004229D, 0x00422C2, 0x0042381, 0x00423CE,
+    0x00423D1, 0x00423DA, 0x00423ED, 0x0042472, 0x004247D, 0x00424EA, 0x00424FD, 0x0042502,
+    0x0042601, 0x00426E2, 0x00426F1, 0x0042742, 0x0042749, 0x0042804, 0x0042812, 0x0042814,
+    0x004281E, 0x0042830, 0x0042841, 0x0042852, 0x0042855, 0x0042862, 0x0042865, 0x00428DA,
+    0x00428E0, 0x00428EE, 0x00428FC, 0x0042901, 0x0042926, 0x0042941, 0x0042966, 0x0042981,
+    0x0042A82, 0x0042B01, 0x0042B94, 0x0042B9E, 0x0042BAD, 0x0042BDE, 0x0042C01, 0x0042CDA,
+    0x0042CE5, 0x0042D5A, 0x0042D61, 0x0042DCE, 0x0042DE1, 0x0042E4A, 0x0042E65, 0x0042E76,
+    0x0042EA5, 0x0042EC2, 0x0043001, 0x0043126, 0x0043201, 0x00432CE, 0x0043301, 0x00433CE,
+    0x00433E9, 0x0043490, 0x00434A2, 0x00434C1, 0x00434EA, 0x0043981, 0x00439FE, 0x0043A01,
+    0x0043AAA, 0x0043AAC, 0x0043AB5, 0x0043ABA, 0x0043AC1, 0x0043ACA, 0x0043C01, 0x0043CA2,
+    0x0043CC1, 0x0043D18, 0x0043D45, 0x0043D6A, 0x0043DC1, 0x0043E08, 0x0043E19, 0x0043E2A,
+    0x0043EC1, 0x0043F32, 0x0043F81, 0x0043FDE, 0x0044001, 0x0044004, 0x0044009, 0x00440E0,
+    0x004411D, 0x004413A, 0x0044149, 0x00441C0, 0x00441C5, 0x00441CC, 0x00441D5, 0x00441DA,
+    0x00441FC, 0x0044209, 0x00442CC, 0x00442DD, 0x00442E4, 0x00442ED, 0x00442F4, 0x00442F9,
+    0x0044308, 0x004430E, 0x0044334, 0x004433A, 0x0044341, 0x00443A6, 0x00443C1, 0x00443EA,
+    0x0044400, 0x004440D, 0x004449C, 0x00444B1, 0x00444B4, 0x00444D6, 0x00444D9, 0x0044522,
+    0x0044541, 0x00445CC, 0x00445D1, 0x00445DE, 0x0044600, 0x0044609, 0x00446D8, 0x00446FD,
+    0x0044724, 0x0044735, 0x004473C, 0x0044741, 0x0044782, 0x0044785, 0x00447D6, 0x0044801,
+    0x004484A, 0x004484D, 0x00448BC, 0x00448C9, 0x00448D0, 0x00448D5, 0x00448D8, 0x00448E1,
+    0x00448F8, 0x00448FE, 0x0044A01, 0x0044A1E, 0x0044A21, 0x0044A26, 0x0044A29, 0x0044A3A,
+    0x0044A3D, 0x0044A7A, 0x0044A7D, 0x0044AAA, 0x0044AC1, 0x0044B7C, 0x0044B81, 0x0044B8C,
+    0x0044BAE, 0x0044BC1, 0x0044BEA, 0x0044C00, 0x0044C09, 0x0044C12, 0x0044C15, 0x0044C36,
+    0x0044C3D, 0x0044C46, 0x0044C4D, 0x0044CA6, 0x0044CA9, 0x0044CC6, 0x0044CC9, 0x0044CD2,
+    0x0044CD5, 0x0044CEA, 0x0044CEC, 0x0044CF5, 0x0044D00, 0x0044D05, 0x0044D16, 0x0044D1D,
+    0x0044D26, 0x0044D2D, 0x0044D3A, 0x0044D41, 0x0044D46, 0x0044D5D, 0x0044D62, 0x0044D75,
+    0x0044D92, 0x0044D98, 0x0044DB6, 0x0044DC0, 0x0044DD6, 0x0045001, 0x00450E0, 0x0045101,
+    0x0045108, 0x0045115, 0x0045118, 0x004511D, 0x0045172, 0x0045175, 0x0045178, 0x004517D,
+    0x004518A, 0x0045201, 0x00452CC, 0x00452E5, 0x00452E8, 0x00452ED, 0x00452FC, 0x0045305,
+    0x0045308, 0x0045311, 0x0045322, 0x0045341, 0x004536A, 0x0045601, 0x00456C8, 0x00456DA,
+    0x00456E1, 0x00456F0, 0x00456F9, 0x00456FC, 0x0045705, 0x0045770, 0x004577A, 0x0045801,
+    0x00458CC, 0x00458ED, 0x00458F4, 0x00458F9, 0x00458FC, 0x0045905, 0x0045916, 0x0045941,
+    0x004596A, 0x0045981, 0x00459B6, 0x0045A01, 0x0045AAC, 0x0045AB1, 0x0045AB4, 0x0045AB9,
+    0x0045AC0, 0x0045AD9, 0x0045ADC, 0x0045AE1, 0x0045AEA, 0x0045B01, 0x0045B2A, 0x0045C01,
+    0x0045C6E, 0x0045C74, 0x0045C81, 0x0045C88, 0x0045C99, 0x0045C9C, 0x0045CB2, 0x0045CC1,
+    0x0045D1E, 0x0046001, 0x00460BC, 0x00460E1, 0x00460E4, 0x00460ED, 0x00460F2, 0x0046281,
+    0x00463CE, 0x00463FD, 0x004641E, 0x0046425, 0x004642A, 0x0046431, 0x0046452, 0x0046455,
+    0x004645E, 0x0046461, 0x00464DA, 0x00464DD, 0x00464E6, 0x00464EC, 0x00464F5, 0x00464F8,
+    0x00464FD, 0x004650C, 0x0046511, 0x004651E, 0x0046541, 0x004656A, 0x0046681, 0x00466A2,
+    0x00466A9, 0x0046750, 0x0046762, 0x0046768, 0x0046771, 0x0046780, 0x0046785, 0x0046796,
+    0x0046801, 0x0046804, 0x004682D, 0x00468CC, 0x00468E5, 0x00468EC, 0x00468FD, 0x004691C,
+    0x0046922, 0x0046941, 0x0046944, 0x004695D, 0x0046964, 0x0046971, 0x0046A28, 0x0046A5D,
+    0x0046A60, 0x0046A69, 0x0046A8E, 0x0046AC1, 0x0046BE6, 0x0047001, 0x0047026, 0x0047029,
+    0x00470C0, 0x00470DE, 0x00470E0, 0x00470F9, 0x00470FC, 0x0047101, 0x004711A, 0x0047141,
+    0x00471B6, 0x00471C1, 0x0047242, 0x0047248, 0x00472A2, 0x00472A5, 0x00472A8, 0x00472C5,
+    0x00472C8, 0x00472D1, 0x00472D4, 0x00472DE, 0x0047401, 0x004741E, 0x0047421, 0x004742A,
+    0x004742D, 0x00474C4, 0x00474DE, 0x00474E8, 0x00474EE, 0x00474F0, 0x00474FA, 0x00474FC,
+    0x0047519, 0x004751C, 0x0047522, 0x0047541, 0x004756A, 0x0047581, 0x004759A, 0x004759D,
+    0x00475A6, 0x00475A9, 0x004763E, 0x0047640, 0x004764A, 0x004764D, 0x0047654, 0x0047659,
+    0x004765C, 0x0047661, 0x0047666, 0x0047681, 0x00476AA, 0x0047B81, 0x0047BCC, 0x0047BD5,
+    0x0047BE6, 0x0047EC1, 0x0047EC6, 0x0047F01, 0x0047FCA, 0x0047FFD, 0x0048E6A, 0x0049001,
+    0x00491BE, 0x00491C1, 0x00491D6, 0x0049201, 0x0049512, 0x004BE41, 0x004BFCE, 0x004C001,
+    0x004D0BE, 0x004D0C0, 0x004D0E6, 0x0051001, 0x005191E, 0x005A001, 0x005A8E6, 0x005A901,
+    0x005A97E, 0x005A981, 0x005A9AA, 0x005A9B9, 0x005AAFE, 0x005AB01, 0x005AB2A, 0x005AB41,
+    0x005ABBA, 0x005ABC0, 0x005ABD5, 0x005ABDA, 0x005AC01, 0x005ACC0, 0x005ACDD, 0x005AD1A,
+    0x005AD41, 0x005AD6A, 0x005AD6D, 0x005AD8A, 0x005AD8D, 0x005ADE2, 0x005ADF5, 0x005AE42,
+    0x005B901, 0x005BA6E, 0x005BC01, 0x005BD2E, 0x005BD3C, 0x005BD41, 0x005BE22, 0x005BE3C,
+    0x005BE4D, 0x005BE82, 0x005BF90, 0x005BF96, 0x006F001, 0x006F1AE, 0x006F1C1, 0x006F1F6,
+    0x006F201, 0x006F226, 0x006F241, 0x006F26A, 0x006F271, 0x006F274, 0x006F27D, 0x006F280,
+    0x006F292, 0x0073C00, 0x0073CBA, 0x0073CC0, 0x0073D1E, 0x0073D41, 0x0073F12, 0x0074001,
+    0x00743DA, 0x0074401, 0x007449E, 0x00744A5, 0x007459C, 0x00745A9, 0x00745CC, 0x007460D,
+    0x0074614, 0x0074631, 0x00746A8, 0x00746B9, 0x00747AE, 0x0074801, 0x0074908, 0x0074915,
+    0x007491A, 0x0074B81, 0x0074BD2, 0x0074C01, 0x0074D5E, 0x0074D81, 0x0074DE6, 0x0075001,
+    0x0075156, 0x0075159, 0x0075276, 0x0075279, 0x0075282, 0x0075289, 0x007528E, 0x0075295,
+    0x007529E, 0x00752A5, 0x00752B6, 0x00752B9, 0x00752EA, 0x00752ED, 0x00752F2, 0x00752F5,
+    0x0075312, 0x0075315, 0x007541A, 0x007541D, 0x007542E, 0x0075435, 0x0075456, 0x0075459,
+    0x0075476, 0x0075479, 0x00754EA, 0x00754ED, 0x00754FE, 0x0075501, 0x0075516, 0x0075519,
+    0x007551E, 0x0075529, 0x0075546, 0x0075549, 0x0075A9A, 0x0075AA1, 0x0075F32, 0x0075F39,
+    0x0076800, 0x00768DD, 0x00768EC, 0x00769B5, 0x00769D4, 0x00769D9, 0x0076A10, 0x0076A15,
+    0x0076A32, 0x0076A6C, 0x0076A82, 0x0076A84, 0x0076AC2, 0x0077C01, 0x0077C7E, 0x0078000,
+    0x007801E, 0x0078020, 0x0078066, 0x007806C, 0x007808A, 0x007808C, 0x0078096, 0x0078098,
+    0x00780AE, 0x0078401, 0x00784B6, 0x00784C0, 0x00784DD, 0x00784FA, 0x0078501, 0x007852A,
+    0x0078539, 0x0078542, 0x0078A41, 0x0078AB8, 0x0078ABE, 0x0078B01, 0x0078BB0, 0x0078BC1,
+    0x0078BEA, 0x0078BFD, 0x0078C02, 0x0079F81, 0x0079F9E, 0x0079FA1, 0x0079FB2, 0x0079FB5,
+    0x0079FBE, 0x0079FC1, 0x0079FFE, 0x007A001, 0x007A316, 0x007A31D, 0x007A340, 0x007A35E,
+    0x007A401, 0x007A510, 0x007A52D, 0x007A532, 0x007A541, 0x007A56A, 0x007A579, 0x007A582,
+    0x007B1C5, 0x007B2D6, 0x007B405, 0x007B4FA, 0x007B801, 0x007B812, 0x007B815, 0x007B882,
+    0x007B885, 0x007B88E, 0x007B891, 0x007B896, 0x007B89D, 0x007B8A2, 0x007B8A5, 0x007B8CE,
+    0x007B8D1, 0x007B8E2, 0x007B8E5, 0x007B8EA, 0x007B8ED, 0x007B8F2, 0x007B909, 0x007B90E,
+    0x007B91D, 0x007B922, 0x007B925, 0x007B92A, 0x007B92D, 0x007B932, 0x007B935, 0x007B942,
+    0x007B945, 0x007B94E, 0x007B951, 0x007B956, 0x007B95D, 0x007B962, 0x007B965, 0x007B96A,
+    0x007B96D, 0x007B972, 0x007B975, 0x007B97A, 0x007B97D, 0x007B982, 0x007B985, 0x007B98E,
+    0x007B991, 0x007B996, 0x007B99D, 0x007B9AE, 0x007B9B1, 0x007B9CE, 0x007B9D1, 0x007B9E2,
+    0x007B9E5, 0x007B9F6, 0x007B9F9, 0x007B9FE, 0x007BA01, 0x007BA2A, 0x007BA2D, 0x007BA72,
+    0x007BA85, 0x007BA92, 0x007BA95, 0x007BAAA, 0x007BAAD, 0x007BAF2, 0x007BBC1, 0x007BBCA,
+    0x007C001, 0x007C012, 0x007C015, 0x007C0B2, 0x007C0C1, 0x007C252, 0x007C281, 0x007C2BE,
+    0x007C2C5, 0x007C302, 0x007C305, 0x007C33E, 0x007C345, 0x007C3DA, 0x007C401, 0x007C63A,
+    0x007C63D, 0x007C646, 0x007C66D, 0x007C6BA, 0x007C799, 0x007C802, 0x007CC85, 0x007CCB6,
+    0x007CCD9, 0x007CCDE, 0x007CDF5, 0x007CDFA, 0x007CE51, 0x007CE82, 0x007CF2D, 0x007CF3E,
+    0x007CF51, 0x007CF82, 0x007CFC5, 0x007CFD2, 0x007CFD5, 0x007CFE2, 0x007D0FD, 0x007D102,
+    0x007D105, 0x007D10A, 0x007D3F5, 0x007D3FE, 0x007D4F9, 0x007D52E, 0x007D53D, 0x007D542,
+    0x007D5A1, 0x007D5EA, 0x007D5ED, 0x007D656, 0x007D65D, 0x007D692, 0x007D695, 0x007D7EE,
+    0x007D941, 0x007DA02, 0x007DB19, 0x007DB32, 0x007DB35, 0x007DB42, 0x007DB4D, 0x007DB56,
+    0x007DB81, 0x007DBAE, 0x007DBC1, 0x007DBD2, 0x007DC01, 0x007DDD2, 0x007DE01, 0x007DF66,
+    0x007E001, 0x007E032, 0x007E041, 0x007E122, 0x007E141, 0x007E16A, 0x007E181, 0x007E222,
+    0x007E241, 0x007E2BA, 0x007E2C1, 0x007E2CA, 0x007E401, 0x007E432, 0x007E4ED, 0x007E4F2,
+    0x007E519, 0x007E51E, 0x007E801, 0x007E952, 0x007E981, 0x007E9BA, 0x007EC01, 0x007EE4E,
+    0x007EE51, 0x007EF2E, 0x007EFC1, 0x007EFEA, 0x0380004, 0x038000A, 0x0380080, 0x0380202,
+    0x0380400, 0x03807C2, 0x03C0001, 0x03FFFFA, 0x0400001, 0x043FFFA,
+};
+//////////////////////////////////////////////////////////////////////////
+static size_t __utf8_code_width( uint32_t _code )
+{
+    if( _code < 0x7F )
+    {
+        return _code < 0x20 ? 0 : 1;
+    }
+
+    size_t lo = 0;
+    size_t hi = sizeof( __utf8_width_ranges ) / sizeof( __utf8_width_ranges[0] );
+
+    while( hi - lo > 1 )
+    {
+        size_t mid = (lo + hi) / 2;
+
+        if( (__utf8_width_ranges[mid] >> 2) <= _code )
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return (size_t)(__utf8_width_ranges[lo] & 0x03);
+}
+//////////////////////////////////////////////////////////////////////////
+size_t utf8_display_width( const char * _utf8, const char * _utf8End )
+{
+    size_t width = 0;
+
+    for( const char * p = _utf8; p != _utf8End; )
+    {
+        size_t ascii = __utf8_printable_ascii_prefix( p, _utf8End );
+
+        width += ascii;
+        p += ascii;
+
+        if( p == _utf8End )
+        {
+            break;
+        }
+
+        uint32_t code;
+        const char * next = utf8_next_code( p, _utf8End, &code );
+
+        if( next == NULL )
+        {
+            return UTF8_UNKNOWN;
+        }
+
+        width += __utf8_code_width( code );
+
+        p = next;
+    }
+
+    return width;
+}
+//////////////////////////////////////////////////////////////////////////
+const char * utf8_display_truncate( const char * _utf8, const char * _utf8End, size_t _columns, size_t * const _width )
+{
+    size_t width = 0;
+
+    const char * p = _utf8;
+
+    while( p != _utf8End )
+    {
+        size_t ascii = __utf8_printable_ascii_prefix( p, _utf8End );
+
+        if( ascii > _columns - width )
+        {
+            ascii = _columns - width;
+        }
+
+        width += ascii;
+        p += ascii;
+
+        if( p == _utf8End )
+        {
+            break;
+        }
+
+        uint32_t code;
+        const char * next = utf8_next_code( p, _utf8End, &code );
+
+        if( next == NULL )
+        {
+            if( width == _columns )
+            {
+                break;
+            }
+
+            return NULL;
+        }
+
+        size_t codeWidth = __utf8_code_width( code );
+
+        if( codeWidth > _columns - width )
+        {
+            break;
+        }
+
+        width += codeWidth;
+
+        p = next;
+    }
+
+    if( _width != NULL )
+    {
+        *_width = width;
+    }
+
+    return p;
+}
+//////////////////////////////////////////////////////////////////////////
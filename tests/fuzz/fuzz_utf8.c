@@ -0,0 +1,29 @@
+#include "utf8_diff.h"
+
+#include <stdint.h>
+
+/*
+ * libFuzzer entry point (clang -fsanitize=fuzzer). AFL++ builds the same file
+ * with afl-clang-fast -fsanitize=fuzzer, or with UTF8_FUZZ_STANDALONE
+ * defined to read a single input from stdin.
+ */
+int LLVMFuzzerTestOneInput( const uint8_t * _data, size_t _size )
+{
+    if( utf8_diff_check( _data, _size ) != 0 )
+    {
+        abort();
+    }
+
+    return 0;
+}
+
+#ifdef UTF8_FUZZ_STANDALONE
+int main( void )
+{
+    static uint8_t buffer[DIFF_MAX_INPUT];
+
+    size_t size = fread( buffer, 1, sizeof( buffer ), stdin );
+
+    return LLVMFuzzerTestOneInput( buffer, size );
+}
+#endif
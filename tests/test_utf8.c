@@ -204,6 +204,20 @@ static int test_utf8_to_unicodez( void )
     n = utf8_to_unicodez( buf, 1, wbuf, sizeof( wbuf ) / sizeof( wchar_t ) );
     TEST( n == UTF8_UNKNOWN );
 
+    /* Invalid continuation byte */
+    memcpy( buf, "\xD0" "A", 3 );
+    n = utf8_to_unicodez( buf, 2, wbuf, sizeof( wbuf ) / sizeof( wchar_t ) );
+    TEST( n == UTF8_UNKNOWN );
+    n = utf8_to_unicodez_size( buf, 2 );
+    TEST( n == UTF8_UNKNOWN );
+
+    /* Truncated sequence before the terminator */
+    memcpy( buf, "\xE6\x97", 3 );
+    n = utf8_to_unicode_size( buf );
+    TEST( n == UTF8_UNKNOWN );
+    n = utf8_to_unicode( buf, wbuf, sizeof( wbuf ) / sizeof( wchar_t ) );
+    TEST( n == UTF8_UNKNOWN );
+
     return 0;
 }
 
@@ -270,6 +284,750 @@ static int test_roundtrip( void )
     return 0;
 }
 
+static int test_utf8_grapheme( void )
+{
+    const char * s;
+    const char * end;
+
+    /* ASCII: one cluster per byte, CR LF is a single cluster */
+    s = "ab\r\nc";
+    end = s + 5;
+    TEST( utf8_next_grapheme( s, end ) == s + 1 );
+    TEST( utf8_next_grapheme( s + 2, end ) == s + 4 );
+    TEST( utf8_grapheme_count( s, end ) == 4 );
+
+    /* Combining mark: "e" + U+0301 */
+    s = "xe\xCC\x81y";
+    end = s + 5;
+    TEST( utf8_next_grapheme( s + 1, end ) == s + 4 );
+    TEST( utf8_grapheme_count( s, end ) == 3 );
+
+    /* Hangul jamo L V T forms one cluster */
+    s = "\xE1\x84\x80\xE1\x85\xA1\xE1\x86\xA8";
+    end = s + 9;
+    TEST( utf8_next_grapheme( s, end ) == end );
+
+    /* Flags: two pairs of regional indicators */
+    s = "\xF0\x9F\x87\xBA\xF0\x9F\x87\xB8\xF0\x9F\x87\xAF\xF0\x9F\x87\xB5";
+    end = s + 16;
+    TEST( utf8_next_grapheme( s, end ) == s + 8 );
+    TEST( utf8_grapheme_count( s, end ) == 2 );
+
+    /* Emoji ZWJ sequence: U+1F468 U+200D U+1F469 */
+    s = "\xF0\x9F\x91\xA8\xE2\x80\x8D\xF0\x9F\x91\xA9";
+    end = s + 11;
+    TEST( utf8_next_grapheme( s, end ) == end );
+
+    /* Invalid UTF-8 */
+    s = "a\x80";
+    end = s + 2;
+    TEST( utf8_next_grapheme( s + 1, end ) == NULL );
+    TEST( utf8_grapheme_count( s, end ) == UTF8_UNKNOWN );
+
+    return 0;
+}
+
+static int test_utf8_display_width( void )
+{
+    const char * s;
+    const char * end;
+    const char * cut;
+    size_t width;
+
+    /* ASCII: width == byte count */
+    s = "hello, world";
+    end = s + 12;
+    TEST( utf8_display_width( s, end ) == 12 );
+
+    /* Wide CJK U+65E5 U+672C and a combining acute accent */
+    s = "a\xE6\x97\xA5\xE6\x9C\xAC" "e\xCC\x81";
+    end = s + 10;
+    TEST( utf8_display_width( s, end ) == 6 );
+
+    /* Truncation never splits a wide character */
+    cut = utf8_display_truncate( s, end, 4, &width );
+    TEST( cut == s + 4 && width == 3 );
+
+    /* Combining mark stays with its base character */
+    cut = utf8_display_truncate( s, end, 6, &width );
+    TEST( cut == end && width == 6 );
+
+    cut = utf8_display_truncate( s, end, 0, &width );
+    TEST( cut == s && width == 0 );
+
+    /* Invalid UTF-8 */
+    s = "ab\xFF";
+    end = s + 3;
+    TEST( utf8_display_width( s, end ) == UTF8_UNKNOWN );
+    TEST( utf8_display_truncate( s, end, 2, &width ) == s + 2 );
+    TEST( utf8_display_truncate( s, end, 3, &width ) == NULL );
+
+    return 0;
+}
+
+static int test_utf8_find( void )
+{
+    const char * s;
+    const char * end;
+    const char * needle;
+    utf8_codeset_t set;
+    uint32_t codes[3];
+    uint32_t cp;
+    static char hay[6000];
+    static char pattern[301];
+    size_t i;
+    size_t len;
+    uint32_t seed;
+
+    /* Non-ASCII needle in a long haystack (exercises the vector filter) */
+    s = "The quick brown fox jumps over the lazy dog, \xD0\xBF\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82 world";
+    end = s + strlen( s );
+    needle = "\xD0\xB2\xD0\xB5";
+    TEST( utf8_find( s, end, needle, needle + 4 ) == s + 51 );
+    needle = "fox";
+    TEST( utf8_find( s, end, needle, needle + 3 ) == s + 16 );
+    needle = "cat";
+    TEST( utf8_find( s, end, needle, needle + 3 ) == NULL );
+    TEST( utf8_find( s, end, needle, needle ) == s );
+
+    /* Invalid needle (starts with a continuation byte) */
+    needle = "\xBF";
+    TEST( utf8_find( s, end, needle, needle + 1 ) == NULL );
+
+    /* Hit that would end inside a longer sequence is rejected */
+    s = "\xC3\x80\x80 \xC3\x80";
+    end = s + 6;
+    needle = "\xC3\x80";
+    TEST( utf8_find( s, end, needle, needle + 2 ) == s + 4 );
+
+    /* Repetitive haystack: nearly every position passes the filter */
+    memset( hay, 'a', sizeof( hay ) );
+    hay[sizeof( hay ) - 1] = 'b';
+    memset( pattern, 'a', sizeof( pattern ) );
+    pattern[sizeof( pattern ) - 1] = 'b';
+    TEST( utf8_find( hay, hay + sizeof( hay ), pattern, pattern + sizeof( pattern ) ) == hay + sizeof( hay ) - sizeof( pattern ) );
+    pattern[sizeof( pattern ) - 1] = 'c';
+    TEST( utf8_find( hay, hay + sizeof( hay ), pattern, pattern + sizeof( pattern ) ) == NULL );
+    pattern[0] = 'b';
+    TEST( utf8_find( hay, hay + sizeof( hay ), pattern, pattern + sizeof( pattern ) ) == NULL );
+
+    /* Two-letter haystack against a naive scan */
+    seed = 12345;
+    for( i = 0; i != sizeof( hay ); ++i )
+    {
+        seed = seed * 1103515245 + 12345;
+        hay[i] = (seed >> 16) % 8 == 0 ? 'b' : 'a';
+    }
+    for( len = 1; len <= sizeof( pattern ); len += 7 )
+    {
+        const char * expected = NULL;
+
+        memcpy( pattern, hay + sizeof( hay ) - len - (len % 13), len );
+        pattern[len / 2] = (char)('a' + 'b' - pattern[len / 2]);
+
+        for( i = 0; i + len <= sizeof( hay ); ++i )
+        {
+            if( memcmp( hay + i, pattern, len ) == 0 )
+            {
+                expected = hay + i;
+                break;
+            }
+        }
+
+        TEST( utf8_find( hay, hay + sizeof( hay ), pattern, pattern + len ) == expected );
+    }
+
+    /* Code point set search */
+    codes[0] = ',';
+    codes[1] = 0x0438;
+    codes[2] = 0x65E5;
+    TEST( utf8_codeset_init( &set, codes, 3 ) == 3 );
+
+    s = "ab\xD0\xBF\xD0\xB8,";
+    end = s + 7;
+    TEST( utf8_find_first_of( s, end, &set, &cp ) == s + 4 && cp == 0x0438 );
+    TEST( utf8_find_first_of( s, s + 4, &set, &cp ) == NULL );
+
+    codes[0] = 0x65E5;
+    TEST( utf8_codeset_init( &set, codes, 3 ) == UTF8_UNKNOWN );
+
+    return 0;
+}
+
+static int test_utf8_json( void )
+{
+    char buf[128];
+    const char * s;
+    const char * end;
+    size_t n;
+
+    /* Escape quote, backslash and control characters */
+    s = "say \"hi\"\\\n\x01 \xD0\xBF";
+    end = s + strlen( s );
+    n = utf8_json_escape( s, end, UTF8_JSON_ESCAPE_DEFAULT, buf, sizeof( buf ) );
+    TEST( n == 23 && memcmp( buf, "say \\\"hi\\\"\\\\\\n\\u0001 \xD0\xBF", 23 ) == 0 );
+    TEST( utf8_json_escape_size( s, end, UTF8_JSON_ESCAPE_DEFAULT ) == 23 );
+
+    /* Escape non-ASCII, including a surrogate pair for U+1F600 */
+    s = "\xD0\xBF\xF0\x9F\x98\x80";
+    end = s + 6;
+    n = utf8_json_escape( s, end, UTF8_JSON_ESCAPE_ASCII, buf, sizeof( buf ) );
+    TEST( n == 18 && memcmp( buf, "\\u043f\\ud83d\\ude00", 18 ) == 0 );
+
+    /* Insufficient capacity and invalid UTF-8 */
+    TEST( utf8_json_escape( s, end, UTF8_JSON_ESCAPE_ASCII, buf, 10 ) == UTF8_UNKNOWN );
+    s = "a\xC0\x81";
+    TEST( utf8_json_escape_size( s, s + 3, UTF8_JSON_ESCAPE_DEFAULT ) == UTF8_UNKNOWN );
+
+    /* Unescape */
+    s = "a\\tb\\u043F\\uD83D\\uDE00\\/";
+    end = s + strlen( s );
+    n = utf8_json_unescape( s, end, buf, sizeof( buf ) );
+    TEST( n == 10 && memcmp( buf, "a\tb\xD0\xBF\xF0\x9F\x98\x80/", 10 ) == 0 );
+
+    /* Unpaired surrogate, bad escape, raw control character */
+    s = "\\uD83Dx";
+    TEST( utf8_json_unescape( s, s + 7, buf, sizeof( buf ) ) == UTF8_UNKNOWN );
+    s = "\\q";
+    TEST( utf8_json_unescape( s, s + 2, buf, sizeof( buf ) ) == UTF8_UNKNOWN );
+    s = "a\nb";
+    TEST( utf8_json_unescape( s, s + 3, buf, sizeof( buf ) ) == UTF8_UNKNOWN );
+
+    return 0;
+}
+
+static int test_utf8_batch( void )
+{
+    utf8_span_t spans[4];
+    size_t offsets[4];
+    utf8_batch_result_t results[4];
+    wchar_t arena[32];
+    size_t n;
+
+    spans[0].data = "key";
+    spans[0].size = 3;
+    spans[1].data = "\xD0\xBF\xD1\x80\xD0\xB8";
+    spans[1].size = 6;
+    spans[2].data = "ab\x80";
+    spans[2].size = 3;
+    spans[3].data = "";
+    spans[3].size = 0;
+
+    TEST( utf8_validate_batch( spans, 4, offsets ) == 1 );
+    TEST( offsets[0] == 3 && offsets[1] == 6 && offsets[2] == 2 && offsets[3] == 0 );
+
+    n = utf8_to_unicodez_batch( spans, 4, arena, 32, results );
+    TEST( n == 6 );
+    TEST( results[0].offset == 0 && results[0].size == 3 && arena[0] == L'k' && arena[2] == L'y' );
+    TEST( results[1].offset == 3 && results[1].size == 3 && arena[3] == 0x043F && arena[5] == 0x0438 );
+    TEST( results[2].size == UTF8_UNKNOWN );
+    TEST( results[3].offset == 6 && results[3].size == 0 );
+
+    /* Arena too small */
+    TEST( utf8_to_unicodez_batch( spans, 2, arena, 4, results ) == UTF8_UNKNOWN );
+
+    /* Groups of short strings are checked together; one non-ASCII byte
+       anywhere sends only its group through the per-string path */
+    for( size_t at = 0; at != 10; ++at )
+    {
+        utf8_span_t many[10];
+        size_t manyOffsets[10];
+        char text[10][20];
+
+        for( size_t index = 0; index != 10; ++index )
+        {
+            memset( text[index], 'a', sizeof( text[index] ) );
+            many[index].data = text[index];
+            many[index].size = 2 + index * 2;
+        }
+
+        TEST( utf8_validate_batch( many, 10, manyOffsets ) == 0 );
+
+        text[at][many[at].size - 1] = '\xC3';
+
+        TEST( utf8_validate_batch( many, 10, manyOffsets ) == 1 );
+        TEST( manyOffsets[at] == many[at].size - 1 && manyOffsets[(at + 1) % 10] == many[(at + 1) % 10].size );
+    }
+
+    return 0;
+}
+
+static int test_utf8_alloc( void )
+{
+    char scratch[256];
+    utf8_arena_t arena;
+    utf8_allocator_t allocator;
+    wchar_t * wide;
+    char * narrow;
+    size_t n;
+
+    /* Default allocator */
+    wide = utf8_to_unicode_alloc( "\xD0\x9C\xD0\xB8\xD1\x80!", UTF8_UNKNOWN, NULL, &n );
+    TEST( wide != NULL && n == 4 && wide[0] == 0x041C && wide[3] == L'!' && wide[4] == L'\0' );
+
+    narrow = utf8_from_unicode_alloc( wide, n, NULL, &n );
+    TEST( narrow != NULL && n == 7 && strcmp( narrow, "\xD0\x9C\xD0\xB8\xD1\x80!" ) == 0 );
+
+    free( wide );
+    free( narrow );
+
+    /* Arena: the over-allocation is shrunk back in place */
+    utf8_arena_init( &arena, scratch, sizeof( scratch ) );
+    utf8_arena_allocator( &arena, &allocator );
+
+    narrow = utf8_from_unicode_alloc( L"hello", UTF8_UNKNOWN, &allocator, &n );
+    TEST( narrow != NULL && n == 5 && strcmp( narrow, "hello" ) == 0 );
+    TEST( arena.size == (size_t)(narrow - scratch) + 6 );
+
+    /* Invalid input releases the block */
+    n = arena.size;
+    TEST( utf8_to_unicode_alloc( "\x80", 1, &allocator, NULL ) == NULL );
+    TEST( arena.size <= n + 16 );
+
+    /* Exhausted arena */
+    utf8_arena_reset( &arena );
+    TEST( arena.size == 0 );
+    TEST( utf8_to_unicode_alloc( scratch, sizeof( scratch ), &allocator, NULL ) == NULL );
+
+    /* Blocks are aligned even when the buffer is not */
+    for( size_t shift = 0; shift != 16; ++shift )
+    {
+        utf8_arena_init( &arena, scratch + shift, sizeof( scratch ) - shift );
+
+        narrow = utf8_from_unicode_alloc( L"a", UTF8_UNKNOWN, &allocator, NULL );
+        wide = utf8_to_unicode_alloc( "abc", 3, &allocator, NULL );
+        TEST( narrow != NULL && ((uintptr_t)narrow & 15) == 0 );
+        TEST( wide != NULL && ((uintptr_t)wide & 15) == 0 && wcscmp( wide, L"abc" ) == 0 );
+    }
+
+    return 0;
+}
+
+#ifdef UTF8_ENABLE_STATS
+static size_t g_stats_begin_calls = 0;
+static size_t g_stats_end_calls = 0;
+
+static void test_stats_begin( utf8_stats_function_e _function, void * _ud )
+{
+    (void)_function;
+    (void)_ud;
+
+    ++g_stats_begin_calls;
+}
+
+static void test_stats_end( utf8_stats_function_e _function, size_t _bytes, size_t _asciiBytes, int _error, void * _ud )
+{
+    (void)_function;
+    (void)_bytes;
+    (void)_asciiBytes;
+    (void)_error;
+    (void)_ud;
+
+    ++g_stats_end_calls;
+}
+
+static int test_utf8_stats( void )
+{
+    utf8_stats_t stats;
+    utf8_stats_t total;
+    utf8_stats_hooks_t hooks;
+    const char * s;
+    char buf[16];
+    char big[100];
+    wchar_t wbuf[16];
+    utf8_span_t span;
+
+    span.data = "\xD0\xBF";
+    span.size = 2;
+
+    hooks.begin = &test_stats_begin;
+    hooks.end = &test_stats_end;
+    hooks.ud = NULL;
+
+    utf8_stats_reset();
+    utf8_stats_set_hooks( &hooks );
+
+    s = "hello";
+    TEST( utf8_validate( s, s + 5 ) == s + 5 );
+    s = "\xD0\xBF!\x80";
+    TEST( utf8_validate( s, s + 4 ) == s + 3 );
+    TEST( utf8_replace_invalid( s, s + 4, buf ) != NULL );
+    TEST( utf8_to_unicodez( "\xD0\xBF!", 3, wbuf, 16 ) == 2 );
+
+    utf8_stats_set_hooks( NULL );
+
+    utf8_stats_get( &stats );
+    TEST( stats.functions[UTF8_STATS_VALIDATE].calls == 2 );
+    TEST( stats.functions[UTF8_STATS_VALIDATE].errors == 1 );
+    TEST( stats.functions[UTF8_STATS_VALIDATE].bytes == 8 );
+    TEST( stats.functions[UTF8_STATS_VALIDATE].ascii_bytes == 6 );
+    TEST( stats.functions[UTF8_STATS_VALIDATE].ascii_calls == 1 );
+    TEST( stats.functions[UTF8_STATS_VALIDATE].paths[UTF8_STATS_PATH_SMALL] == 1 );
+    TEST( stats.functions[UTF8_STATS_VALIDATE].paths[UTF8_STATS_PATH_SCALAR] == 1 );
+    TEST( stats.functions[UTF8_STATS_REPLACE_INVALID].errors == 1 );
+    TEST( stats.functions[UTF8_STATS_REPLACE_INVALID].ascii_bytes == 1 );
+    TEST( stats.functions[UTF8_STATS_TO_UNICODE].bytes == 3 );
+    TEST( stats.functions[UTF8_STATS_TO_UNICODE].ascii_bytes == 1 );
+    TEST( stats.functions[UTF8_STATS_TO_UNICODE].ascii_calls == 0 );
+    TEST( g_stats_begin_calls == 4 && g_stats_end_calls == 4 );
+
+    memset( &total, 0, sizeof( total ) );
+    utf8_stats_accumulate( &total, &stats );
+    utf8_stats_accumulate( &total, &stats );
+    TEST( total.functions[UTF8_STATS_VALIDATE].calls == 4 );
+
+    utf8_stats_reset();
+    utf8_stats_get( &stats );
+    TEST( stats.functions[UTF8_STATS_VALIDATE].calls == 0 );
+
+    /* Long ASCII is settled by the vector kernel alone */
+    memset( big, 'a', sizeof( big ) );
+    TEST( utf8_validate( big, big + sizeof( big ) ) == big + sizeof( big ) );
+    utf8_stats_get( &stats );
+    TEST( stats.functions[UTF8_STATS_VALIDATE].paths[UTF8_STATS_PATH_ASCII] == 1 );
+
+    /* The library's own use of instrumented functions is not counted */
+    utf8_stats_reset();
+    TEST( utf8_find( big, big + sizeof( big ), "aa", (const char *)"aa" + 2 ) == big );
+    TEST( utf8_validate_batch( &span, 1, NULL ) == 0 );
+    free( utf8_to_unicode_alloc( "abc", 3, NULL, NULL ) );
+    utf8_stats_get( &stats );
+    TEST( stats.functions[UTF8_STATS_VALIDATE].calls == 0 && stats.functions[UTF8_STATS_TO_UNICODE].calls == 0 );
+
+    return 0;
+}
+#endif
+
+static int test_utf8_segments( void )
+{
+    utf8_span_t segments[3];
+    wchar_t wbuf[16];
+    size_t n;
+
+    /* "A" U+65E5 "B" with the 3-byte sequence split across a ring buffer wrap */
+    segments[0].data = "A\xE6";
+    segments[0].size = 2;
+    segments[1].data = "";
+    segments[1].size = 0;
+    segments[2].data = "\x97\xA5" "B";
+    segments[2].size = 3;
+
+    TEST( utf8_validate_segments( segments, 3 ) == 5 );
+    TEST( utf8_to_unicode_segments_size( segments, 3 ) == 3 );
+    n = utf8_to_unicode_segments( segments, 3, wbuf, 16 );
+    TEST( n == 3 && wbuf[0] == L'A' && wbuf[1] == 0x65E5 && wbuf[2] == L'B' );
+
+    /* Truncated sequence at the very end */
+    TEST( utf8_validate_segments( segments, 1 ) == 1 );
+    TEST( utf8_to_unicode_segments_size( segments, 1 ) == UTF8_UNKNOWN );
+
+    /* Invalid continuation in the next segment */
+    segments[2].data = "\x97" "B";
+    segments[2].size = 2;
+    TEST( utf8_validate_segments( segments, 3 ) == 1 );
+    TEST( utf8_to_unicode_segments( segments, 3, wbuf, 16 ) == UTF8_UNKNOWN );
+
+    return 0;
+}
+
+static int test_utf8_small_strings( void )
+{
+    char buf[48];
+    wchar_t wbuf[48];
+
+    /* Every length up to past the small-string limit, with and without a
+       non-ASCII byte at each position */
+    for( size_t size = 0; size != 40; ++size )
+    {
+        memset( buf, 'a', sizeof( buf ) );
+
+        TEST( utf8_validate( buf, buf + size ) == buf + size );
+        TEST( utf8_to_unicodez_size( buf, size ) == size );
+        TEST( size == 0 || utf8_to_unicodez( buf, size, wbuf, 48 ) == size );
+        TEST( size == 0 || wbuf[size - 1] == L'a' );
+
+        for( size_t at = 0; at != size; ++at )
+        {
+            buf[at] = '\x80';
+
+            TEST( utf8_validate( buf, buf + size ) == buf + at );
+            TEST( utf8_to_unicodez_size( buf, size ) == UTF8_UNKNOWN );
+
+            buf[at] = 'a';
+        }
+
+        for( size_t at = 0; at != size; ++at )
+        {
+            wbuf[at] = L'a';
+        }
+
+        TEST( size == 0 || utf8_from_unicodez( wbuf, size, buf, 48 ) == size );
+
+        /* a unit is non-ASCII through its low byte or only its high bits */
+        for( size_t at = 0; at != size; ++at )
+        {
+            wbuf[at] = (wchar_t)0xE9;
+            TEST( utf8_from_unicodez( wbuf, size, buf, 48 ) == size + 1 );
+
+            wbuf[at] = (wchar_t)0x4100;
+            TEST( utf8_from_unicodez( wbuf, size, buf, 48 ) == size + 2 );
+
+            wbuf[at] = L'a';
+        }
+    }
+
+    return 0;
+}
+
+static int test_utf8_detect( void )
+{
+    utf8_detect_t result;
+    char buf[64];
+
+    TEST( utf8_detect( "plain text", 10, &result ) == UTF8_ENCODING_ASCII );
+    TEST( result.ranking[1] == UTF8_ENCODING_UTF8 && result.high_bytes == 0 );
+
+    TEST( utf8_detect( "caf\xC3\xA9 na\xC3\xAFve", 12, &result ) == UTF8_ENCODING_UTF8 );
+    TEST( result.utf8_invalid_offset == 12 && result.high_bytes == 4 );
+
+    /* A sequence cut off by the sample end is still UTF-8 */
+    TEST( utf8_detect( "caf\xC3\xA9 \xE6\x97", 8, NULL ) == UTF8_ENCODING_UTF8 );
+
+    /* BOMs win outright */
+    TEST( utf8_detect( "\xEF\xBB\xBFhi", 5, &result ) == UTF8_ENCODING_UTF8 && result.bom_size == 3 );
+    TEST( utf8_detect( "\xEF\xBB\xBF\0h\0", 6, &result ) == UTF8_ENCODING_UTF8 && result.nul_odd == 2 );
+    TEST( utf8_detect( "\xFF\xFEh\0i\0", 6, &result ) == UTF8_ENCODING_UTF16LE && result.bom_size == 2 );
+    TEST( utf8_detect( "\xFE\xFF\0h\0i", 6, &result ) == UTF8_ENCODING_UTF16BE );
+
+    /* BOM-less UTF-16 from NUL parity, across the vector block size */
+    for( size_t index = 0; index != 32; ++index )
+    {
+        buf[index * 2] = 'a' + (char)(index % 26);
+        buf[index * 2 + 1] = '\0';
+    }
+
+    TEST( utf8_detect( buf, 64, &result ) == UTF8_ENCODING_UTF16LE && result.nul_odd == 32 && result.nul_even == 0 );
+    TEST( utf8_detect( buf + 1, 62, &result ) == UTF8_ENCODING_UTF16BE && result.nul_even == 31 );
+
+    /* Windows-1252 smart quotes vs. Latin-1 */
+    TEST( utf8_detect( "\x93quoted\x94 caf\xE9", 13, &result ) == UTF8_ENCODING_WINDOWS1252 );
+    TEST( result.c1_bytes == 2 && result.utf8_invalid_offset == 0 );
+    TEST( utf8_detect( "\x81\x8D caf\xE9", 7, &result ) == UTF8_ENCODING_LATIN1 );
+    TEST( result.ranking[1] == UTF8_ENCODING_WINDOWS1252 );
+
+    TEST( utf8_detect( "", 0, &result ) == UTF8_ENCODING_ASCII );
+
+    return 0;
+}
+
+static int test_utf8_codepage( void )
+{
+    char buf[64];
+    char back[64];
+    size_t n;
+
+    /* Windows-1252 smart quotes and euro sign */
+    TEST( utf8_from_codepage_size( "\x93" "5\x80\x94", 4, &utf8_codepage_windows1252 ) == 10 );
+    n = utf8_from_codepage( "\x93" "5\x80\x94", 4, &utf8_codepage_windows1252, buf, sizeof( buf ) );
+    TEST( n == 10 && memcmp( buf, "\xE2\x80\x9C" "5\xE2\x82\xAC\xE2\x80\x9D", 10 ) == 0 );
+    TEST( utf8_to_codepage( buf, n, &utf8_codepage_windows1252, back, sizeof( back ) ) == 4 );
+    TEST( memcmp( back, "\x93" "5\x80\x94", 4 ) == 0 );
+
+    /* Undefined Windows-1252 bytes round-trip through C1 */
+    n = utf8_from_codepage( "\x81", 1, &utf8_codepage_windows1252, buf, sizeof( buf ) );
+    TEST( n == 2 && memcmp( buf, "\xC2\x81", 2 ) == 0 );
+
+    /* KOI8-R and ISO-8859-5 "Мир" */
+    n = utf8_from_codepage( "\xED\xC9\xD2", 3, &utf8_codepage_koi8r, buf, sizeof( buf ) );
+    TEST( n == 6 && memcmp( buf, "\xD0\x9C\xD0\xB8\xD1\x80", 6 ) == 0 );
+    TEST( utf8_to_codepage( buf, n, &utf8_codepage_iso8859_5, back, sizeof( back ) ) == 3 );
+    TEST( memcmp( back, "\xBC\xD8\xE0", 3 ) == 0 );
+
+    /* Not representable, invalid UTF-8, capacity */
+    TEST( utf8_to_codepage( "\xE2\x82\xAC", 3, &utf8_codepage_latin1, back, sizeof( back ) ) == UTF8_UNKNOWN );
+    TEST( utf8_to_codepage( "a\xC3", 2, &utf8_codepage_latin1, back, sizeof( back ) ) == UTF8_UNKNOWN );
+    TEST( utf8_from_codepage( "abc\xE9", UTF8_UNKNOWN, &utf8_codepage_latin1, buf, 4 ) == UTF8_UNKNOWN );
+    TEST( utf8_from_codepage( "abc\xE9", UTF8_UNKNOWN, &utf8_codepage_latin1, buf, 5 ) == 5 );
+
+    /* Custom page with an unmapped byte */
+    {
+        utf8_codepage_t page;
+        uint16_t high[128];
+
+        for( size_t index = 0; index != 128; ++index )
+        {
+            high[index] = (uint16_t)(0x0400 + index);
+        }
+
+        high[0x7F] = 0;
+
+        TEST( utf8_codepage_init( &page, high ) == 127 );
+        TEST( utf8_from_codepage_size( "a\xFF", 2, &page ) == UTF8_UNKNOWN );
+        TEST( utf8_to_codepage( "\xD0\x81", 2, &page, back, sizeof( back ) ) == 1 && (uint8_t)back[0] == 0x81 );
+
+        high[0] = 0xD800;
+        TEST( utf8_codepage_init( &page, high ) == UTF8_UNKNOWN );
+    }
+
+    /* Every byte of every built-in page round-trips */
+    {
+        const utf8_codepage_t * pages[4] = {&utf8_codepage_windows1252, &utf8_codepage_latin1, &utf8_codepage_koi8r, &utf8_codepage_iso8859_5};
+
+        for( size_t p = 0; p != 4; ++p )
+        {
+            utf8_codepage_t page;
+
+            TEST( utf8_codepage_init( &page, pages[p]->high ) == pages[p]->reverse_count );
+            TEST( memcmp( page.encoded, pages[p]->encoded, sizeof( page.encoded ) ) == 0 );
+            TEST( memcmp( page.reverse, pages[p]->reverse, sizeof( page.reverse ) ) == 0 );
+
+            for( size_t byte = 1; byte != 256; ++byte )
+            {
+                char in = (char)byte;
+
+                n = utf8_from_codepage( &in, 1, pages[p], buf, sizeof( buf ) );
+                TEST( n != UTF8_UNKNOWN && utf8_validate( buf, buf + n ) == buf + n );
+                TEST( utf8_to_codepage( buf, n, pages[p], back, sizeof( back ) ) == 1 && back[0] == in );
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int test_utf8_cesu8( void )
+{
+    char buf[64];
+    char back[64];
+    size_t n;
+
+    /* U+1F600 is a surrogate pair in CESU-8; BMP text is unchanged */
+    const char utf8[] = "a\xC3\xA9\xF0\x9F\x98\x80z";
+    const char cesu8[] = "a\xC3\xA9\xED\xA0\xBD\xED\xB8\x80z";
+
+    TEST( utf8_to_cesu8_size( utf8, utf8 + 8, UTF8_CESU8_DEFAULT ) == 10 );
+    n = utf8_to_cesu8( utf8, utf8 + 8, UTF8_CESU8_DEFAULT, buf, sizeof( buf ) );
+    TEST( n == 10 && memcmp( buf, cesu8, 10 ) == 0 );
+
+    TEST( utf8_from_cesu8_size( cesu8, cesu8 + 10, UTF8_CESU8_DEFAULT ) == 8 );
+    n = utf8_from_cesu8( cesu8, cesu8 + 10, UTF8_CESU8_DEFAULT, back, sizeof( back ) );
+    TEST( n == 8 && memcmp( back, utf8, 8 ) == 0 );
+
+    /* Modified UTF-8 encodes NUL as C0 80 and rejects a raw NUL */
+    n = utf8_to_cesu8( "a\0b", (const char *)"a\0b" + 3, UTF8_CESU8_MODIFIED, buf, sizeof( buf ) );
+    TEST( n == 4 && memcmp( buf, "a\xC0\x80" "b", 4 ) == 0 );
+    n = utf8_from_cesu8( buf, buf + 4, UTF8_CESU8_MODIFIED, back, sizeof( back ) );
+    TEST( n == 3 && memcmp( back, "a\0b", 3 ) == 0 );
+    TEST( utf8_from_cesu8( buf, buf + 4, UTF8_CESU8_DEFAULT, back, sizeof( back ) ) == UTF8_UNKNOWN );
+    TEST( utf8_from_cesu8_size( "a\0b", (const char *)"a\0b" + 3, UTF8_CESU8_MODIFIED ) == UTF8_UNKNOWN );
+    TEST( utf8_to_cesu8_size( "a\0b", (const char *)"a\0b" + 3, UTF8_CESU8_DEFAULT ) == 3 );
+
+    /* Unpaired surrogates, 4-byte sequences and invalid UTF-8 */
+    TEST( utf8_from_cesu8_size( cesu8, cesu8 + 6, UTF8_CESU8_DEFAULT ) == UTF8_UNKNOWN );
+    TEST( utf8_from_cesu8_size( cesu8 + 6, cesu8 + 10, UTF8_CESU8_DEFAULT ) == UTF8_UNKNOWN );
+    TEST( utf8_from_cesu8_size( utf8, utf8 + 8, UTF8_CESU8_DEFAULT ) == UTF8_UNKNOWN );
+    TEST( utf8_to_cesu8_size( "\xC0\x80", (const char *)"\xC0\x80" + 2, UTF8_CESU8_MODIFIED ) == UTF8_UNKNOWN );
+
+    /* Capacity */
+    TEST( utf8_to_cesu8( utf8, utf8 + 8, UTF8_CESU8_DEFAULT, buf, 9 ) == UTF8_UNKNOWN );
+    TEST( utf8_from_cesu8( cesu8, cesu8 + 10, UTF8_CESU8_DEFAULT, back, 7 ) == UTF8_UNKNOWN );
+
+    return 0;
+}
+
+static int test_utf8_sanitize( void )
+{
+    utf8_sanitize_t config;
+    char out[128];
+    size_t n;
+
+    /* Log line with an injected newline, a bidi override, a C1 control,
+       a noncharacter and an invalid byte */
+    const char input[] = "user=a\nb \xE2\x80\xAEgpj.exe\xC2\x85\xEF\xBF\xBE\xFF\tok";
+    const char * end = input + sizeof( input ) - 1;
+
+    utf8_sanitize_init( &config, UTF8_SANITIZE_ESCAPE );
+    n = utf8_sanitize( input, end, &config, out, sizeof( out ) );
+    TEST( n == utf8_sanitize_size( input, end, &config ) );
+    TEST( n == 44 && memcmp( out, "user=a\\x0Ab \\u202Egpj.exe\\u0085\\uFFFE\\xFF\tok", 44 ) == 0 );
+
+    utf8_sanitize_init( &config, UTF8_SANITIZE_DROP );
+    n = utf8_sanitize( input, end, &config, out, sizeof( out ) );
+    TEST( n == 18 && memcmp( out, "user=ab gpj.exe\tok", 18 ) == 0 );
+
+    /* Replacing only invalid UTF-8 matches utf8_replace_invalid() */
+    {
+        char replaced[128];
+        const char * replacedEnd = utf8_replace_invalid( input, end, replaced );
+
+        utf8_sanitize_init( &config, UTF8_SANITIZE_KEEP );
+        config.actions[UTF8_SANITIZE_INVALID] = UTF8_SANITIZE_REPLACE;
+        n = utf8_sanitize( input, end, &config, out, sizeof( out ) );
+        TEST( n == (size_t)(replacedEnd - replaced) && memcmp( out, replaced, n ) == 0 );
+    }
+
+    /* Keep line breaks, escape everything else; capacity is checked */
+    utf8_sanitize_init( &config, UTF8_SANITIZE_ESCAPE );
+    config.actions[UTF8_SANITIZE_LINE_BREAK] = UTF8_SANITIZE_KEEP;
+    n = utf8_sanitize( "a\r\nb\x01", (const char *)"a\r\nb\x01" + 5, &config, out, sizeof( out ) );
+    TEST( n == 8 && memcmp( out, "a\r\nb\\x01", 8 ) == 0 );
+    TEST( utf8_sanitize( "a\r\nb\x01", (const char *)"a\r\nb\x01" + 5, &config, out, 7 ) == UTF8_UNKNOWN );
+
+    /* A literal backslash is escaped too, so the text \x01 and the byte
+       0x01 stay distinct */
+    n = utf8_sanitize( "\\x01", (const char *)"\\x01" + 4, &config, out, sizeof( out ) );
+    TEST( n == 5 && memcmp( out, "\\\\x01", 5 ) == 0 );
+    TEST( utf8_sanitize( "\x01", (const char *)"\x01" + 1, &config, out, sizeof( out ) ) == 4 && memcmp( out, "\\x01", 4 ) == 0 );
+    TEST( utf8_sanitize_size( "a\\b\\", (const char *)"a\\b\\" + 4, &config ) == 6 );
+    n = utf8_sanitize( "C:\\Program Files\\Common Files\\x", (const char *)"C:\\Program Files\\Common Files\\x" + 31, &config, out, sizeof( out ) );
+    TEST( n == 34 && memcmp( out, "C:\\\\Program Files\\\\Common Files\\\\x", 34 ) == 0 );
+
+    /* Without escaping, backslashes pass through */
+    utf8_sanitize_init( &config, UTF8_SANITIZE_REPLACE );
+    TEST( utf8_sanitize( "\\x01", (const char *)"\\x01" + 4, &config, out, sizeof( out ) ) == 4 && memcmp( out, "\\x01", 4 ) == 0 );
+
+    return 0;
+}
+
+static int test_utf8_isa( void )
+{
+    char buf[200];
+
+    TEST( utf8_isa_supported( UTF8_ISA_AUTO ) == 1 && utf8_isa_supported( UTF8_ISA_SCALAR ) == 1 );
+    TEST( utf8_isa_active() != UTF8_ISA_AUTO );
+    TEST( strcmp( utf8_isa_name( UTF8_ISA_AVX512 ), "avx512" ) == 0 && utf8_isa_name( __UTF8_ISA_COUNT__ ) == NULL );
+
+    /* Every supported path gives the same answers around its block sizes */
+    for( int isa = UTF8_ISA_SCALAR; isa != __UTF8_ISA_COUNT__; ++isa )
+    {
+        if( utf8_isa_supported( (utf8_isa_e)isa ) == 0 )
+        {
+            TEST( utf8_isa_select( (utf8_isa_e)isa ) != (utf8_isa_e)isa );
+
+            continue;
+        }
+
+        TEST( utf8_isa_select( (utf8_isa_e)isa ) == (utf8_isa_e)isa && utf8_isa_active() == (utf8_isa_e)isa );
+
+        for( size_t at = 0; at != 150; ++at )
+        {
+            memset( buf, 'a', sizeof( buf ) );
+            buf[at] = '\x80';
+
+            TEST( utf8_validate( buf, buf + 160 ) == buf + at );
+
+            buf[at] = '\x01';
+
+            TEST( utf8_validate( buf, buf + 160 ) == buf + 160 );
+            TEST( utf8_display_width( buf, buf + 160 ) == 159 );
+        }
+    }
+
+    TEST( utf8_isa_select( UTF8_ISA_AUTO ) != UTF8_ISA_AUTO );
+
+    return 0;
+}
+
 int main( void )
 {
     int failed = 0;
@@ -281,6 +1039,22 @@ int main( void )
     failed += test_utf8_to_unicodez();
     failed += test_utf8_from_unicode32();
     failed += test_roundtrip();
+    failed += test_utf8_grapheme();
+    failed += test_utf8_display_width();
+    failed += test_utf8_find();
+    failed += test_utf8_json();
+    failed += test_utf8_batch();
+    failed += test_utf8_alloc();
+#ifdef UTF8_ENABLE_STATS
+    failed += test_utf8_stats();
+#endif
+    failed += test_utf8_segments();
+    failed += test_utf8_small_strings();
+    failed += test_utf8_detect();
+    failed += test_utf8_codepage();
+    failed += test_utf8_cesu8();
+    failed += test_utf8_sanitize();
+    failed += test_utf8_isa();
 
     if( failed == 0 )
     {
@@ -0,0 +1,141 @@
+#include "utf8_diff.h"
+
+#include <stdint.h>
+
+#define DIFF_ITERATIONS (50000)
+
+static uint64_t g_state = 0x9E3779B97F4A7C15ULL;
+
+static uint32_t diff_random( void )
+{
+    g_state ^= g_state << 13;
+    g_state ^= g_state >> 7;
+    g_state ^= g_state << 17;
+
+    return (uint32_t)(g_state >> 32);
+}
+
+static uint32_t diff_random_code( void )
+{
+    static const uint32_t edges[] = {
+        0x00, 0x09, 0x0A, 0x0D, 0x22, 0x5C, 0x7F, 0x80, 0x301, 0x7FF, 0x800,
+        0x1100, 0x1161, 0x11A8, 0x200D, 0xAC00, 0xD7FF, 0xE000, 0xFFFD, 0xFFFF,
+        0x10000, 0x1F1E6, 0x1F468, 0x1F3FB, 0x10FFFF
+    };
+
+    switch( diff_random() % 6 )
+    {
+    case 0:
+    case 1:
+        return 0x20 + diff_random() % 0x5F;
+    case 2:
+        return edges[diff_random() % (sizeof( edges ) / sizeof( edges[0] ))];
+    case 3:
+        return 0x80 + diff_random() % 0x780;
+    case 4:
+        return 0x800 + diff_random() % 0xF800;
+    default:
+        return 0x10000 + diff_random() % 0x100000;
+    }
+}
+
+static size_t diff_generate( uint8_t * _out, size_t _capacity )
+{
+    static const uint8_t invalid[][3] = {
+        { 0x80, 0, 0 }, { 0xC0, 0x81, 0 }, { 0xC1, 0xBF, 0 }, { 0xED, 0xA0, 0x80 },
+        { 0xF4, 0x90, 0x80 }, { 0xF5, 0, 0 }, { 0xFF, 0, 0 }, { 0xE0, 0x80, 0x80 }
+    };
+
+    size_t target = diff_random() % 4 == 0 ? diff_random() % 300 : diff_random() % 40;
+
+    if( target > _capacity - 4 )
+    {
+        target = _capacity - 4;
+    }
+
+    size_t n = 0;
+
+    if( diff_random() % 8 == 0 )
+    {
+        /* unstructured bytes */
+        while( n < target )
+        {
+            _out[n++] = (uint8_t)diff_random();
+        }
+
+        return n;
+    }
+
+    while( n < target )
+    {
+        uint32_t code = diff_random_code();
+
+        if( code >= 0xD800 && code <= 0xDFFF )
+        {
+            continue;
+        }
+
+        n += ref_encode( code, _out + n );
+    }
+
+    /* structured mutations */
+    size_t mutations = diff_random() % 4;
+
+    for( size_t m = 0; m != mutations && n != 0; ++m )
+    {
+        size_t at = diff_random() % n;
+
+        switch( diff_random() % 4 )
+        {
+        case 0:
+            _out[at] ^= (uint8_t)(1 << (diff_random() % 8));
+            break;
+        case 1:
+            _out[at] = (uint8_t)diff_random();
+            break;
+        case 2:
+            n = at;
+            break;
+        default:
+            {
+                const uint8_t * seq = invalid[diff_random() % (sizeof( invalid ) / sizeof( invalid[0] ))];
+
+                for( size_t k = 0; k != 3 && at + k < n && (k == 0 || seq[k] != 0); ++k )
+                {
+                    _out[at + k] = seq[k];
+                }
+            }
+            break;
+        }
+    }
+
+    return n;
+}
+
+int main( void )
+{
+    static uint8_t buffer[512];
+
+    for( size_t iteration = 0; iteration != DIFF_ITERATIONS; ++iteration )
+    {
+        size_t n = diff_generate( buffer, sizeof( buffer ) );
+
+        if( utf8_diff_check( buffer, n ) != 0 )
+        {
+            fprintf( stderr, "iteration %u, input:", (unsigned)iteration );
+
+            for( size_t i = 0; i != n; ++i )
+            {
+                fprintf( stderr, " %02X", buffer[i] );
+            }
+
+            fprintf( stderr, "\n" );
+
+            return 1;
+        }
+    }
+
+    printf( "Differential tests passed.\n" );
+
+    return 0;
+}
@@ -0,0 +1,821 @@
+#ifndef UTF8_DIFF_H_
+#define UTF8_DIFF_H_
+
+#include "utf8/utf8.h"
+#include "utf8_internal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+/*
+ * Differential checks of the public API against a straightforward reference
+ * implementation of the Unicode well-formed byte sequence table (Table 3-7).
+ * Shared by the randomized ctest harness and the fuzz targets.
+ */
+
+#define DIFF_CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "DIFF: %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define DIFF_MAX_INPUT (4096)
+
+static size_t ref_decode( const uint8_t * _p, size_t _n, uint32_t * _code )
+{
+    if( _n == 0 )
+    {
+        return 0;
+    }
+
+    uint8_t b0 = _p[0];
+
+    if( b0 <= 0x7F )
+    {
+        *_code = b0;
+
+        return 1;
+    }
+
+    size_t len;
+    uint8_t lo = 0x80;
+    uint8_t hi = 0xBF;
+
+    if( b0 >= 0xC2 && b0 <= 0xDF )
+    {
+        len = 2;
+    }
+    else if( b0 == 0xE0 )
+    {
+        len = 3;
+        lo = 0xA0;
+    }
+    else if( (b0 >= 0xE1 && b0 <= 0xEC) || b0 == 0xEE || b0 == 0xEF )
+    {
+        len = 3;
+    }
+    else if( b0 == 0xED )
+    {
+        len = 3;
+        hi = 0x9F;
+    }
+    else if( b0 == 0xF0 )
+    {
+        len = 4;
+        lo = 0x90;
+    }
+    else if( b0 >= 0xF1 && b0 <= 0xF3 )
+    {
+        len = 4;
+    }
+    else if( b0 == 0xF4 )
+    {
+        len = 4;
+        hi = 0x8F;
+    }
+    else
+    {
+        return 0;
+    }
+
+    if( _n < len || _p[1] < lo || _p[1] > hi )
+    {
+        return 0;
+    }
+
+    uint32_t code = b0 & (0xFF >> (len + 1));
+
+    for( size_t i = 1; i != len; ++i )
+    {
+        if( i > 1 && (_p[i] < 0x80 || _p[i] > 0xBF) )
+        {
+            return 0;
+        }
+
+        code = (code << 6) | (_p[i] & 0x3F);
+    }
+
+    *_code = code;
+
+    return len;
+}
+
+static size_t ref_validate( const uint8_t * _p, size_t _n )
+{
+    size_t i = 0;
+
+    while( i < _n )
+    {
+        uint32_t code;
+        size_t len = ref_decode( _p + i, _n - i, &code );
+
+        if( len == 0 )
+        {
+            return i;
+        }
+
+        i += len;
+    }
+
+    return _n;
+}
+
+static size_t ref_count( const uint8_t * _p, size_t _n )
+{
+    size_t count = 0;
+
+    for( size_t i = 0; i < _n; ++count )
+    {
+        uint32_t code;
+        size_t len = ref_decode( _p + i, _n - i, &code );
+
+        if( len == 0 )
+        {
+            return UTF8_UNKNOWN;
+        }
+
+        i += len;
+    }
+
+    return count;
+}
+
+static size_t ref_encode( uint32_t _code, uint8_t * _out )
+{
+    if( _code < 0x80 )
+    {
+        _out[0] = (uint8_t)_code;
+
+        return 1;
+    }
+    else if( _code < 0x800 )
+    {
+        _out[0] = (uint8_t)(0xC0 | (_code >> 6));
+        _out[1] = (uint8_t)(0x80 | (_code & 0x3F));
+
+        return 2;
+    }
+    else if( _code >= 0xD800 && _code <= 0xDFFF )
+    {
+        return 0;
+    }
+    else if( _code < 0x10000 )
+    {
+        _out[0] = (uint8_t)(0xE0 | (_code >> 12));
+        _out[1] = (uint8_t)(0x80 | ((_code >> 6) & 0x3F));
+        _out[2] = (uint8_t)(0x80 | (_code & 0x3F));
+
+        return 3;
+    }
+    else if( _code <= 0x10FFFF )
+    {
+        _out[0] = (uint8_t)(0xF0 | (_code >> 18));
+        _out[1] = (uint8_t)(0x80 | ((_code >> 12) & 0x3F));
+        _out[2] = (uint8_t)(0x80 | ((_code >> 6) & 0x3F));
+        _out[3] = (uint8_t)(0x80 | (_code & 0x3F));
+
+        return 4;
+    }
+
+    return 0;
+}
+
+/* inverse of UTF8_SANITIZE_ESCAPE: \\, \xHH (a raw byte), \uXXXX and
+   \UXXXXXXXX (code points); UTF8_UNKNOWN on a malformed escape */
+static size_t ref_unescape( const uint8_t * _p, size_t _n, uint8_t * _out )
+{
+    size_t size = 0;
+
+    for( size_t i = 0; i < _n; )
+    {
+        if( _p[i] != '\\' )
+        {
+            _out[size++] = _p[i++];
+
+            continue;
+        }
+
+        if( i + 1 == _n )
+        {
+            return UTF8_UNKNOWN;
+        }
+
+        uint8_t kind = _p[i + 1];
+
+        if( kind == '\\' )
+        {
+            _out[size++] = '\\';
+            i += 2;
+
+            continue;
+        }
+
+        size_t digits = kind == 'x' ? 2 : kind == 'u' ? 4 : kind == 'U' ? 8 : 0;
+
+        if( digits == 0 || _n - i - 2 < digits )
+        {
+            return UTF8_UNKNOWN;
+        }
+
+        uint32_t code = 0;
+
+        for( size_t k = 0; k != digits; ++k )
+        {
+            uint8_t c = _p[i + 2 + k];
+
+            code = code * 16 + (uint32_t)(c <= '9' ? c - '0' : c - 'A' + 10);
+        }
+
+        if( kind == 'x' )
+        {
+            _out[size++] = (uint8_t)code;
+        }
+        else
+        {
+            size += ref_encode( code, _out + size );
+        }
+
+        i += 2 + digits;
+    }
+
+    return size;
+}
+
+static int diff_decoding( const uint8_t * _p, size_t _n )
+{
+    const char * s = (const char *)_p;
+    const char * e = s + _n;
+
+    /* utf8_next_code along the reference decode path */
+    size_t valid = ref_validate( _p, _n );
+
+    for( size_t i = 0; i < _n; )
+    {
+        uint32_t refCode = 0;
+        uint32_t code = 0;
+        size_t len = ref_decode( _p + i, _n - i, &refCode );
+        const char * next = utf8_next_code( s + i, e, &code );
+
+        if( len == 0 )
+        {
+            DIFF_CHECK( next == NULL );
+            ++i;
+            continue;
+        }
+
+        DIFF_CHECK( next == s + i + len && code == refCode );
+
+        i += len;
+    }
+
+    DIFF_CHECK( utf8_next_code( e, e, NULL ) == NULL );
+
+    /* utf8_validate */
+    DIFF_CHECK( utf8_validate( s, e ) == s + valid );
+
+    /* utf8_replace_invalid: one U+FFFD per byte that starts no valid sequence */
+    {
+        static uint8_t ref[DIFF_MAX_INPUT * 3];
+        static char out[DIFF_MAX_INPUT * 3];
+
+        size_t refSize = 0;
+
+        for( size_t i = 0; i < _n; )
+        {
+            uint32_t code;
+            size_t len = ref_decode( _p + i, _n - i, &code );
+
+            if( len == 0 )
+            {
+                code = 0xFFFD;
+                len = 1;
+            }
+
+            refSize += ref_encode( code, ref + refSize );
+            i += len;
+        }
+
+        const char * outEnd = utf8_replace_invalid( s, e, out );
+
+        DIFF_CHECK( outEnd != NULL && (size_t)(outEnd - out) == refSize );
+        DIFF_CHECK( memcmp( out, ref, refSize ) == 0 );
+    }
+
+    /* utf8_to_unicodez_size / utf8_to_unicodez */
+    {
+        static wchar_t wide[DIFF_MAX_INPUT + 1];
+
+        size_t count = ref_count( _p, _n );
+
+        DIFF_CHECK( utf8_to_unicodez_size( s, _n ) == count );
+
+        size_t n = utf8_to_unicodez( s, _n, wide, _n + 1 );
+
+        DIFF_CHECK( n == (_n == 0 ? 0 : count) );
+
+        if( count != UTF8_UNKNOWN )
+        {
+            size_t i = 0;
+
+            for( size_t k = 0; k != count; ++k )
+            {
+                uint32_t code;
+                i += ref_decode( _p + i, _n - i, &code );
+
+                DIFF_CHECK( wide[k] == (wchar_t)code );
+            }
+
+            /* truncation at a smaller capacity keeps the prefix */
+            if( count > 1 )
+            {
+                DIFF_CHECK( utf8_to_unicodez( s, _n, wide, count / 2 ) == count / 2 );
+            }
+        }
+    }
+
+    /* NUL-terminated variants see the prefix up to the first NUL; the copy is
+       exactly sized so that sanitizer builds (the fuzz target) catch any read
+       past the terminator. The plain utf8_diff_test build only compares
+       results and cannot detect an over-read. */
+    {
+        size_t z = 0;
+
+        while( z != _n && _p[z] != 0 )
+        {
+            ++z;
+        }
+
+        char * copy = (char *)malloc( z + 1 );
+        wchar_t * wide = (wchar_t *)malloc( (z + 1) * sizeof( wchar_t ) );
+
+        memcpy( copy, _p, z );
+        copy[z] = '\0';
+
+        size_t count = ref_count( _p, z );
+
+        size_t sizeResult = utf8_to_unicode_size( copy );
+        size_t convertResult = utf8_to_unicode( copy, wide, z + 1 );
+
+        free( copy );
+        free( wide );
+
+        DIFF_CHECK( sizeResult == count );
+        DIFF_CHECK( convertResult == count );
+    }
+
+    return 0;
+}
+
+static int diff_encoding( const uint8_t * _p, size_t _n )
+{
+    static wchar_t wide[DIFF_MAX_INPUT / 3 + 2];
+    static uint8_t ref[DIFF_MAX_INPUT * 2];
+    static char out[DIFF_MAX_INPUT * 2];
+
+    /* every 3 input bytes make one (possibly invalid) code unit */
+    size_t count = 0;
+
+    for( size_t i = 0; i + 3 <= _n; i += 3 )
+    {
+        uint32_t code = (((uint32_t)_p[i] << 16) | ((uint32_t)_p[i + 1] << 8) | _p[i + 2]) % 0x110100;
+
+        if( sizeof( wchar_t ) == 2 )
+        {
+            code &= 0xFFFF;
+        }
+
+        if( code == 0 )
+        {
+            code = 0x20;
+        }
+
+        wide[count++] = (wchar_t)code;
+
+        char symbol[5];
+        size_t refLen = ref_encode( code, ref );
+        size_t len = utf8_from_unicode32_symbol( code, symbol );
+
+        DIFF_CHECK( len == (refLen == 0 ? UTF8_UNKNOWN : refLen) );
+        DIFF_CHECK( refLen == 0 || memcmp( symbol, ref, refLen ) == 0 );
+    }
+
+    wide[count] = L'\0';
+
+    size_t refSize = 0;
+
+    for( size_t k = 0; k != count; ++k )
+    {
+        size_t len = ref_encode( (uint32_t)wide[k], ref + refSize );
+
+        if( len == 0 )
+        {
+            refSize = UTF8_UNKNOWN;
+            break;
+        }
+
+        refSize += len;
+    }
+
+    DIFF_CHECK( utf8_from_unicodez_size( wide, count ) == refSize );
+    DIFF_CHECK( utf8_from_unicode_size( wide ) == refSize );
+    DIFF_CHECK( utf8_from_unicodez( wide, count, out, sizeof( out ) ) == (count == 0 ? 0 : refSize) );
+    DIFF_CHECK( utf8_from_unicode( wide, out, sizeof( out ) ) == (count == 0 ? 0 : refSize) );
+
+    if( refSize != UTF8_UNKNOWN )
+    {
+        DIFF_CHECK( memcmp( out, ref, refSize ) == 0 );
+
+        /* one byte short of the output size fails instead of truncating */
+        DIFF_CHECK( refSize < 2 || utf8_from_unicodez( wide, count, out, refSize - 1 ) == UTF8_UNKNOWN );
+    }
+
+    /* short pure ASCII strings take the small-string path */
+    {
+        wchar_t asciiWide[40];
+        char asciiOut[41];
+        size_t asciiCount = _n < 40 ? _n : 40;
+
+        for( size_t k = 0; k != asciiCount; ++k )
+        {
+            asciiWide[k] = (wchar_t)(0x20 + _p[k] % 0x5F);
+        }
+
+        DIFF_CHECK( utf8_from_unicodez( asciiWide, asciiCount, asciiOut, asciiCount + 1 ) == asciiCount );
+
+        for( size_t k = 0; k != asciiCount; ++k )
+        {
+            DIFF_CHECK( (wchar_t)asciiOut[k] == asciiWide[k] );
+        }
+    }
+
+    return 0;
+}
+
+static int diff_extensions( const uint8_t * _p, size_t _n )
+{
+    const char * s = (const char *)_p;
+    const char * e = s + _n;
+
+    size_t valid = ref_validate( _p, _n );
+    size_t count = ref_count( _p, _n );
+
+    /* accelerated ASCII scans against their byte-wise definition */
+    for( size_t i = 0; i <= _n; i += 1 + (i & 7) )
+    {
+        size_t ascii = 0;
+        size_t printable = 0;
+
+        while( i + ascii != _n && _p[i + ascii] < 0x80 )
+        {
+            ++ascii;
+        }
+
+        while( i + printable != _n && _p[i + printable] >= 0x20 && _p[i + printable] < 0x7F )
+        {
+            ++printable;
+        }
+
+        DIFF_CHECK( __utf8_ascii_prefix( s + i, e ) == ascii );
+        DIFF_CHECK( __utf8_printable_ascii_prefix( s + i, e ) == printable );
+    }
+
+    /* grapheme clusters partition valid input */
+    {
+        size_t graphemes = utf8_grapheme_count( s, e );
+
+        DIFF_CHECK( (graphemes == UTF8_UNKNOWN) == (count == UTF8_UNKNOWN) );
+
+        if( graphemes != UTF8_UNKNOWN )
+        {
+            size_t clusters = 0;
+
+            for( const char * p = s; p != e; ++clusters )
+            {
+                const char * next = utf8_next_grapheme( p, e );
+
+                DIFF_CHECK( next != NULL && next > p && next <= e );
+
+                p = next;
+            }
+
+            DIFF_CHECK( clusters == graphemes && graphemes <= count );
+        }
+    }
+
+    /* display width */
+    {
+        size_t width = utf8_display_width( s, e );
+
+        DIFF_CHECK( (width == UTF8_UNKNOWN) == (count == UTF8_UNKNOWN) );
+
+        if( width != UTF8_UNKNOWN )
+        {
+            size_t truncated;
+
+            DIFF_CHECK( width <= 2 * count );
+            DIFF_CHECK( utf8_display_truncate( s, e, width, &truncated ) == e && truncated == width );
+            DIFF_CHECK( utf8_display_truncate( s, e, width / 2, &truncated ) != NULL && truncated <= width / 2 );
+        }
+    }
+
+    /* substring search against a naive scan */
+    if( _n > 2 )
+    {
+        size_t at = _p[0] % _n;
+        size_t len = 1 + _p[1] % 6;
+
+        if( at + len > _n )
+        {
+            len = _n - at;
+        }
+
+        const char * needle = s + at;
+        const char * needleEnd = needle + len;
+
+        const char * expected = NULL;
+
+        if( ref_validate( _p + at, len ) == len )
+        {
+            for( size_t i = 0; i + len <= _n; ++i )
+            {
+                if( memcmp( s + i, needle, len ) == 0 && (i + len == _n || (_p[i + len] & 0xC0) != 0x80) )
+                {
+                    expected = s + i;
+                    break;
+                }
+            }
+        }
+
+        DIFF_CHECK( utf8_find( s, e, needle, needleEnd ) == expected );
+    }
+
+    /* JSON escape round trip */
+    {
+        static char escaped[DIFF_MAX_INPUT * 12];
+        static char unescaped[DIFF_MAX_INPUT * 12];
+
+        for( uint32_t flags = 0; flags != 2; ++flags )
+        {
+            size_t size = utf8_json_escape_size( s, e, flags );
+            size_t written = utf8_json_escape( s, e, flags, escaped, sizeof( escaped ) );
+
+            DIFF_CHECK( size == written );
+            DIFF_CHECK( (written == UTF8_UNKNOWN) == (count == UTF8_UNKNOWN) );
+
+            if( written != UTF8_UNKNOWN )
+            {
+                size_t back = utf8_json_unescape( escaped, escaped + written, unescaped, sizeof( unescaped ) );
+
+                DIFF_CHECK( back == _n && memcmp( unescaped, _p, _n ) == 0 );
+            }
+        }
+    }
+
+    /* batch validation and conversion of the input split into short
+       strings, grouped across the packed-check limit, with a few long ones */
+    {
+        static wchar_t arena[DIFF_MAX_INPUT];
+        utf8_span_t spans[12];
+        size_t offsets[12];
+        utf8_batch_result_t results[12];
+        size_t spanCount = 0;
+
+        for( size_t i = 0; i < _n && spanCount != 12; ++spanCount )
+        {
+            size_t len = 1 + _p[i] % 40;
+
+            if( len > _n - i )
+            {
+                len = _n - i;
+            }
+
+            spans[spanCount].data = s + i;
+            spans[spanCount].size = len;
+
+            i += len;
+        }
+
+        size_t invalid = 0;
+        size_t total = 0;
+
+        for( size_t k = 0; k != spanCount; ++k )
+        {
+            size_t valid = ref_validate( (const uint8_t *)spans[k].data, spans[k].size );
+
+            invalid += valid != spans[k].size;
+            total += valid == spans[k].size ? ref_count( (const uint8_t *)spans[k].data, spans[k].size ) : 0;
+        }
+
+        DIFF_CHECK( utf8_validate_batch( spans, spanCount, offsets ) == invalid );
+        DIFF_CHECK( utf8_to_unicodez_batch( spans, spanCount, arena, DIFF_MAX_INPUT, results ) == total );
+
+        for( size_t k = 0; k != spanCount; ++k )
+        {
+            size_t valid = ref_validate( (const uint8_t *)spans[k].data, spans[k].size );
+
+            DIFF_CHECK( offsets[k] == valid );
+            DIFF_CHECK( results[k].size == (valid == spans[k].size ? ref_count( (const uint8_t *)spans[k].data, spans[k].size ) : UTF8_UNKNOWN) );
+        }
+    }
+
+    /* segmented input split at every few bytes, including empty segments */
+    {
+        static wchar_t wide[DIFF_MAX_INPUT + 1];
+        utf8_span_t segments[16];
+        size_t segmentCount = 0;
+        size_t i = 0;
+
+        while( i < _n && segmentCount != 15 )
+        {
+            size_t len = (_p[i] + segmentCount) % 5;
+
+            if( len > _n - i )
+            {
+                len = _n - i;
+            }
+
+            segments[segmentCount].data = s + i;
+            segments[segmentCount].size = len;
+            ++segmentCount;
+
+            i += len;
+        }
+
+        segments[segmentCount].data = s + i;
+        segments[segmentCount].size = _n - i;
+        ++segmentCount;
+
+        DIFF_CHECK( utf8_validate_segments( segments, segmentCount ) == valid );
+        DIFF_CHECK( utf8_to_unicode_segments_size( segments, segmentCount ) == count );
+        DIFF_CHECK( utf8_to_unicode_segments( segments, segmentCount, wide, _n + 1 ) == (_n == 0 ? 0 : count) );
+
+        if( count != UTF8_UNKNOWN )
+        {
+            size_t k = 0;
+
+            for( size_t j = 0; j < _n; ++k )
+            {
+                uint32_t code;
+                j += ref_decode( _p + j, _n - j, &code );
+
+                DIFF_CHECK( wide[k] == (wchar_t)code );
+            }
+        }
+    }
+
+    /* allocating conversion matches the reference */
+    {
+        size_t n;
+        wchar_t * wide = utf8_to_unicode_alloc( s, _n, NULL, &n );
+
+        DIFF_CHECK( (wide == NULL) == (valid != _n) );
+
+        if( wide != NULL )
+        {
+            DIFF_CHECK( n == count && wide[n] == L'\0' );
+
+            free( wide );
+        }
+    }
+
+    /* detection counters match a byte-wise count */
+    {
+        utf8_detect_t detect;
+        utf8_detect( s, _n, &detect );
+
+        size_t high = 0;
+        size_t nul[2] = {0, 0};
+
+        for( size_t i = detect.bom_size; i != _n; ++i )
+        {
+            high += _p[i] >= 0x80;
+            nul[i & 1] += _p[i] == 0;
+        }
+
+        DIFF_CHECK( detect.high_bytes == high );
+        DIFF_CHECK( detect.nul_even == nul[0] && detect.nul_odd == nul[1] );
+        DIFF_CHECK( valid == _n ? detect.utf8_invalid_offset == _n : detect.utf8_invalid_offset >= valid );
+    }
+
+    /* CESU-8 and Modified UTF-8 round-trip valid UTF-8 and reject the rest */
+    for( uint32_t flags = UTF8_CESU8_DEFAULT; flags <= UTF8_CESU8_MODIFIED; ++flags )
+    {
+        static char cesu8[DIFF_MAX_INPUT * 2];
+        static char back[DIFF_MAX_INPUT];
+
+        size_t n = utf8_to_cesu8_size( s, e, flags );
+
+        DIFF_CHECK( (n == UTF8_UNKNOWN) == (valid != _n) );
+
+        if( n != UTF8_UNKNOWN && _n != 0 )
+        {
+            DIFF_CHECK( utf8_to_cesu8( s, e, flags, cesu8, sizeof( cesu8 ) ) == n );
+            DIFF_CHECK( utf8_from_cesu8_size( cesu8, cesu8 + n, flags ) == _n );
+            DIFF_CHECK( utf8_from_cesu8( cesu8, cesu8 + n, flags, back, sizeof( back ) ) == _n && memcmp( back, s, _n ) == 0 );
+        }
+
+        size_t m = utf8_from_cesu8_size( s, e, flags );
+
+        if( m != UTF8_UNKNOWN && _n != 0 )
+        {
+            static char utf8[DIFF_MAX_INPUT];
+
+            DIFF_CHECK( utf8_from_cesu8( s, e, flags, utf8, sizeof( utf8 ) ) == m );
+            DIFF_CHECK( ref_validate( (const uint8_t *)utf8, m ) == m );
+        }
+    }
+
+    /* sanitizing only invalid UTF-8 is utf8_replace_invalid(); escaping
+       everything leaves valid UTF-8 without unsafe code points */
+    {
+        static char replaced[DIFF_MAX_INPUT * 3];
+        static char sanitized[DIFF_MAX_INPUT * 4];
+
+        utf8_sanitize_t config;
+        utf8_sanitize_init( &config, UTF8_SANITIZE_KEEP );
+        config.actions[UTF8_SANITIZE_INVALID] = UTF8_SANITIZE_REPLACE;
+
+        size_t replacedSize = (size_t)(utf8_replace_invalid( s, e, replaced ) - replaced);
+
+        DIFF_CHECK( utf8_sanitize_size( s, e, &config ) == replacedSize );
+        DIFF_CHECK( _n == 0 || (utf8_sanitize( s, e, &config, sanitized, sizeof( sanitized ) ) == replacedSize && memcmp( sanitized, replaced, replacedSize ) == 0) );
+
+        utf8_sanitize_init( &config, UTF8_SANITIZE_ESCAPE );
+
+        size_t n = _n == 0 ? 0 : utf8_sanitize( s, e, &config, sanitized, sizeof( sanitized ) );
+
+        DIFF_CHECK( n == utf8_sanitize_size( s, e, &config ) );
+        DIFF_CHECK( ref_validate( (const uint8_t *)sanitized, n ) == n );
+
+        for( size_t i = 0; i < n; )
+        {
+            uint32_t code;
+            i += ref_decode( (const uint8_t *)sanitized + i, n - i, &code );
+
+            DIFF_CHECK( code == '\t' || (code >= 0x20 && code != 0x7F && (code < 0x80 || code > 0x9F)) );
+            DIFF_CHECK( code != 0x202E && code != 0x2028 && (code & 0xFFFE) != 0xFFFE );
+        }
+
+        /* escapes are unambiguous: the input comes back exactly */
+        static uint8_t unescaped[DIFF_MAX_INPUT * 4];
+
+        DIFF_CHECK( ref_unescape( (const uint8_t *)sanitized, n, unescaped ) == _n );
+        DIFF_CHECK( _n == 0 || memcmp( unescaped, _p, _n ) == 0 );
+    }
+
+    /* any byte string round-trips through Windows-1252 */
+    {
+        static char utf8[DIFF_MAX_INPUT * 3];
+        static char back[DIFF_MAX_INPUT];
+
+        size_t n = utf8_from_codepage( s, _n, &utf8_codepage_windows1252, utf8, sizeof( utf8 ) );
+
+        DIFF_CHECK( _n == 0 || n == utf8_from_codepage_size( s, _n, &utf8_codepage_windows1252 ) );
+        DIFF_CHECK( _n == 0 || utf8_validate( utf8, utf8 + n ) == utf8 + n );
+        DIFF_CHECK( _n == 0 || (utf8_to_codepage( utf8, n, &utf8_codepage_windows1252, back, sizeof( back ) ) == _n && memcmp( back, s, _n ) == 0) );
+    }
+
+    return 0;
+}
+
+static int utf8_diff_check( const uint8_t * _data, size_t _size )
+{
+    if( _size > DIFF_MAX_INPUT )
+    {
+        _size = DIFF_MAX_INPUT;
+    }
+
+    /* every kernel path this machine supports must agree with the reference */
+    for( int isa = UTF8_ISA_SCALAR; isa != __UTF8_ISA_COUNT__; ++isa )
+    {
+        if( utf8_isa_supported( (utf8_isa_e)isa ) == 0 )
+        {
+            continue;
+        }
+
+        utf8_isa_select( (utf8_isa_e)isa );
+
+        int failed = diff_decoding( _data, _size ) != 0
+            || diff_encoding( _data, _size ) != 0
+            || diff_extensions( _data, _size ) != 0;
+
+        if( failed != 0 )
+        {
+            fprintf( stderr, "kernel path: %s\n", utf8_isa_name( (utf8_isa_e)isa ) );
+
+            utf8_isa_select( UTF8_ISA_AUTO );
+
+            return 1;
+        }
+    }
+
+    utf8_isa_select( UTF8_ISA_AUTO );
+
+    return 0;
+}
+
+#endif